@@ -292,6 +292,7 @@ export default function App() {
           setBuyInModal(true, seatIndex);
         }}
         onHostAction={(action, payload = {}) => sendAction(action, payload)}
+        onToggleHeroEquity={(enabled) => sendAction("set_hero_equity", { enabled })}
         onSendChat={sendChatMessage}
       />
 
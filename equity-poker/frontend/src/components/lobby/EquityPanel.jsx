@@ -6,7 +6,16 @@ function formatEquity(value) {
   return `${pct.toFixed(1)}%`;
 }
 
-export default function EquityPanel({ game, equities }) {
+// Most likely final hand, e.g. "Two Pair 34%"
+function topCategory(categories) {
+  if (!categories || typeof categories !== "object") return "";
+  const entries = Object.entries(categories);
+  if (!entries.length) return "";
+  const [name, value] = entries.reduce((best, e) => (e[1] > best[1] ? e : best));
+  return `${name} ${formatEquity(value)}`;
+}
+
+export default function EquityPanel({ game, equities, breakdown, outs }) {
   if (!equities || typeof equities !== "object") return null;
 
   const rows = Object.entries(equities)
@@ -17,7 +26,9 @@ export default function EquityPanel({ game, equities }) {
       return {
         seatIndex: index,
         name: seat.name || seat.id,
-        equity: value
+        equity: value,
+        stats: breakdown?.[seatIndex],
+        outs: Array.isArray(outs?.[seatIndex]) ? outs[seatIndex] : []
       };
     })
     .filter(Boolean)
@@ -30,9 +41,24 @@ export default function EquityPanel({ game, equities }) {
       <h3 className="mb-2 text-sm font-semibold text-indigo-200">Equity</h3>
       <div className="space-y-1.5">
         {rows.map((row) => (
-          <div key={row.seatIndex} className="flex items-center justify-between rounded bg-slate-900/50 px-2 py-1.5 text-xs">
-            <span className="truncate pr-2 text-slate-200">{row.name}</span>
-            <span className="font-semibold text-indigo-200">{formatEquity(row.equity)}</span>
+          <div key={row.seatIndex} className="rounded bg-slate-900/50 px-2 py-1.5 text-xs">
+            <div className="flex items-center justify-between">
+              <span className="truncate pr-2 text-slate-200">{row.name}</span>
+              <span className="font-semibold text-indigo-200">{formatEquity(row.equity)}</span>
+            </div>
+            {row.stats && (
+              <div className="mt-0.5 flex items-center justify-between text-[11px] text-slate-400">
+                <span>
+                  W {formatEquity(row.stats.win)} / T {formatEquity(row.stats.tie)}
+                </span>
+                <span className="truncate pl-2">{topCategory(row.stats.categories)}</span>
+              </div>
+            )}
+            {row.outs.length > 0 && (
+              <div className="mt-0.5 truncate text-[11px] text-emerald-300">
+                {row.outs.length} outs: {row.outs.map((c) => c.str).join(" ")}
+              </div>
+            )}
           </div>
         ))}
       </div>
@@ -0,0 +1,24 @@
+function formatEquity(value) {
+  if (typeof value !== "number" || Number.isNaN(value)) {
+    return "--";
+  }
+  return `${(value * 100).toFixed(1)}%`;
+}
+
+// A seated player's own equity against random hands (opt-in)
+export default function HeroEquityPanel({ enabled, equity, onToggle }) {
+  return (
+    <div className="rounded-2xl border border-indigo-700/60 bg-indigo-950/30 p-4">
+      <label className="flex cursor-pointer items-center justify-between text-sm font-semibold text-indigo-200">
+        <span>My equity vs random hands</span>
+        <input type="checkbox" checked={enabled} onChange={(e) => onToggle?.(e.target.checked)} />
+      </label>
+      {enabled && (
+        <div className="mt-2 flex items-center justify-between rounded bg-slate-900/50 px-2 py-1.5 text-xs">
+          <span className="text-slate-300">Equity</span>
+          <span className="font-semibold text-indigo-200">{formatEquity(equity)}</span>
+        </div>
+      )}
+    </div>
+  );
+}
@@ -2,6 +2,7 @@ import TableView from "../game/TableView";
 import SpectatorPanel from "./SpectatorPanel";
 import HostControls from "./HostControls";
 import EquityPanel from "./EquityPanel";
+import HeroEquityPanel from "./HeroEquityPanel";
 import ChatPanel from "./ChatPanel";
 
 export default function LobbyView({
@@ -14,6 +15,7 @@ export default function LobbyView({
   nextHandCountdownSec,
   onSeatClick,
   onHostAction,
+  onToggleHeroEquity,
   onSendChat
 }) {
   const users = Array.isArray(snapshot?.users) ? snapshot.users : [];
@@ -61,7 +63,21 @@ export default function LobbyView({
             <SpectatorPanel users={users} embedded />
           </div>
         </details>
-        {viewerIsSpectator && <EquityPanel game={game} equities={equities} />}
+        {viewerIsSpectator && (
+          <EquityPanel
+            game={game}
+            equities={equities}
+            breakdown={snapshot?.equityBreakdown}
+            outs={snapshot?.outs?.outs}
+          />
+        )}
+        {viewer && !viewerIsSpectator && (
+          <HeroEquityPanel
+            enabled={!!viewer.heroEquity}
+            equity={snapshot?.heroEquity}
+            onToggle={onToggleHeroEquity}
+          />
+        )}
         <ChatPanel
           messages={chatMessages}
           myUserId={myUserId}
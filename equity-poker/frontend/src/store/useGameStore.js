@@ -300,6 +300,27 @@ export const useGameStore = create((set, get) => ({
       return;
     }
 
+    // Equity is computed in the background and arrives after the state
+    if (msg.kind === "event" && msg.event === "equity_update") {
+      const equities = msg?.data?.equities;
+      if (equities && typeof equities === "object") {
+        // Breakdown and outs only come with the final numbers
+        const { equityBreakdown, outs } = msg.data;
+        set((state) =>
+          state.snapshot
+            ? { snapshot: { ...state.snapshot, equities, equityBreakdown, outs } }
+            : {}
+        );
+      }
+      const heroEquity = msg?.data?.heroEquity;
+      if (typeof heroEquity === "number") {
+        set((state) =>
+          state.snapshot ? { snapshot: { ...state.snapshot, heroEquity } } : {}
+        );
+      }
+      return;
+    }
+
     if (msg.kind === "event" && msg.event === "game_state") {
       if (!msg.data || typeof msg.data !== "object") {
         const message = "Received invalid game state payload.";
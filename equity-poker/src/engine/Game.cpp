@@ -1,5 +1,6 @@
 #include "Game.h"
 #include "../poker/Evaluator.h"
+#include "../poker/ShortDeckEvaluator.h"
 #include <iostream>
 #include <nlohmann/json.hpp>
 
@@ -32,12 +33,13 @@ void Game::startHand() {
   pot = 0;
   currentBet = 0;
   board.clear();
+  burned.clear();
   sidePots.clear();
   showdownResults.clear();
   isAllInShowdown = false;
   foldWinner = -1;
   hasActedThisStreet.assign(config.maxSeats, false);
-  deck = Deck();
+  deck = Deck(config.shortDeck);
   deck.shuffle(rng);
 
   // Move button to next eligible player
@@ -242,6 +244,7 @@ int Game::seatedPlayerCountWithChips() const {
 void Game::resetForEndGame() {
   stage = GameStage::Idle;
   board.clear();
+  burned.clear();
   sidePots.clear();
   showdownResults.clear();
   isAllInShowdown = false;
@@ -530,18 +533,23 @@ void Game::nextStreet() {
   } else if (stage == GameStage::River) {
     stage = GameStage::Showdown;
     distributePot();
+    if (streetListener)
+      streetListener(stage);
     return;
   }
 
   // Deal community cards (3 on flop, 1 on turn/river)
   int cardsToDeal = (stage == GameStage::Flop) ? 3 : 1;
-  if (!deck.getCards().empty())
-    deck.deal(); // Burn
+  if (deck.count() > 0)
+    burned.push_back(deck.deal()); // Burn
   for (int i = 0; i < cardsToDeal; i++) {
-    if (!deck.getCards().empty())
+    if (deck.count() > 0)
       board.push_back(deck.deal());
   }
 
+  if (streetListener)
+    streetListener(stage);
+
   if (bettingPlayerCount() == 0)
     return;
 
@@ -636,9 +644,37 @@ void Game::resolveSidePots() {
 void Game::distributePot() {
   resolveSidePots();
 
-  Evaluator eval;
   showdownResults.clear();
 
+  // Score every seat that still holds cards in one batch, then reuse the
+  // ranks for each side pot and the showdown results
+  const CardSet boardSet = CardSet::fromCards(board);
+  std::vector<CardSet> seatCards;
+  std::vector<int> scoredSeats;
+  for (int i = 0; i < config.maxSeats; i++) {
+    if (seats[i].status == PlayerStatus::Folded ||
+        seats[i].status == PlayerStatus::SittingOut ||
+        seats[i].status == PlayerStatus::Waiting || seats[i].hand.empty())
+      continue;
+
+    CardSet sevenCards = CardSet::fromCards(seats[i].hand) | boardSet;
+    if (sevenCards.size() >= 5) {
+      seatCards.push_back(sevenCards);
+      scoredSeats.push_back(i);
+    }
+  }
+  std::vector<int> seatRanks(seatCards.size());
+  if (config.shortDeck)
+    ShortDeckEvaluator::evaluateBatch(seatCards.data(), seatCards.size(),
+                                      seatRanks.data());
+  else
+    Evaluator::evaluateBatch(seatCards.data(), seatCards.size(),
+                             seatRanks.data());
+
+  std::vector<int> handRankPerSeat(config.maxSeats, 99999);
+  for (size_t k = 0; k < scoredSeats.size(); k++)
+    handRankPerSeat[scoredSeats[k]] = seatRanks[k];
+
   // Detect all-in showdown
   int activeBettors = 0;
   for (const auto &p : seats) {
@@ -672,12 +708,7 @@ void Game::distributePot() {
       winners.push_back(eligibleIdx[0]);
     } else {
       for (int idx : eligibleIdx) {
-        std::vector<Card> sevenCards = seats[idx].hand;
-        sevenCards.insert(sevenCards.end(), board.begin(), board.end());
-
-        int score = 99999;
-        if (sevenCards.size() >= 5)
-          score = eval.evaluate(sevenCards);
+        int score = handRankPerSeat[idx];
 
         if (score < bestScore) {
           bestScore = score;
@@ -728,10 +759,7 @@ void Game::distributePot() {
       result.seatIndex = i;
       result.chipsWon = chipsWonPerSeat[i];
 
-      std::vector<Card> sevenCards = seats[i].hand;
-      sevenCards.insert(sevenCards.end(), board.begin(), board.end());
-      if (sevenCards.size() >= 5)
-        result.handRank = eval.evaluate(sevenCards);
+      result.handRank = handRankPerSeat[i];
 
       result.mustShow = (chipsWonPerSeat[i] > 0) || isAllInShowdown;
       result.hasDecided = result.mustShow; // Forced-show = already decided
@@ -807,6 +835,12 @@ int Game::findSeatIndex(const std::string &id) const {
   return -1;
 }
 
+bool Game::peekNextBurn(Card &card) const {
+  if (stage != GameStage::Flop && stage != GameStage::Turn)
+    return false;
+  return deck.peek(card);
+}
+
 // JSON Serialization Helpers
 NLOHMANN_JSON_SERIALIZE_ENUM(GameStage, {{GameStage::Idle, "Idle"},
                                          {GameStage::PreFlop, "PreFlop"},
@@ -2,6 +2,7 @@
 #include "../poker/Deck.h"
 #include "Player.h"
 #include <algorithm>
+#include <functional>
 #include <random>
 #include <string>
 #include <unordered_set>
@@ -32,6 +33,7 @@ public:
     int bigBlind = 10;
     int maxSeats = 6;
     int startingStack = 1000;
+    bool shortDeck = false; // 6+ Hold'em: 36 cards, flush beats full house
     Config() {}
   };
 
@@ -77,6 +79,17 @@ public:
   bool getIsAllInShowdown() const { return isAllInShowdown; }
   int getFoldWinner() const { return foldWinner; }
 
+  // Cards burned this hand (server side only: nobody at the table sees
+  // them) and the one the next street will burn, if any
+  const std::vector<Card> &getBurnedCards() const { return burned; }
+  bool peekNextBurn(Card &card) const;
+
+  // Called at the end of every nextStreet (after the new cards are dealt,
+  // or after the pot is paid at Showdown) with the new stage
+  void setStreetListener(std::function<void(GameStage)> listener) {
+    streetListener = std::move(listener);
+  }
+
   friend void to_json(nlohmann::json &j, const Game &g);
 
 private:
@@ -84,6 +97,7 @@ private:
   std::vector<Player> seats;
   std::vector<SidePot> sidePots;
   std::vector<Card> board;
+  std::vector<Card> burned;
   Deck deck;
   std::mt19937 rng;
 
@@ -103,6 +117,7 @@ private:
   std::vector<ShowdownResult> showdownResults;
   bool isAllInShowdown = false;
   int foldWinner = -1;
+  std::function<void(GameStage)> streetListener;
 
   void nextTurn();
   void nextStreet();
@@ -0,0 +1,87 @@
+#include "BoardRankTable.h"
+#include "Evaluator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace poker {
+
+// Combo of cards i < j -> j * (j - 1) / 2 + i
+int BoardRankTable::comboIndex(const Card &a, const Card &b) {
+  int i = cardIndex(a);
+  int j = cardIndex(b);
+  if (i > j)
+    std::swap(i, j);
+  return j * (j - 1) / 2 + i;
+}
+
+void BoardRankTable::comboCards(int combo, Card &a, Card &b) {
+  int j = 1;
+  while ((j + 1) * j / 2 <= combo)
+    j++;
+  a = cardFromIndex(combo - j * (j - 1) / 2);
+  b = cardFromIndex(j);
+}
+
+BoardRankTable::BoardRankTable(const std::vector<Card> &boardCards) {
+  board = CardSet::fromCards(boardCards);
+  if (boardCards.size() != 5 || board.size() != 5)
+    throw std::invalid_argument("BoardRankTable needs 5 distinct cards");
+
+  unsigned char counts[13] = {0};
+  for (const auto &c : boardCards)
+    counts[c.rank()]++;
+
+  // 1. Without a flush only the hole ranks matter:
+  // 91 rank pairs cover all 1326 combos
+  short pairRank[13][13] = {{0}};
+  for (int r1 = 0; r1 < 13; r1++) {
+    for (int r2 = r1; r2 < 13; r2++) {
+      counts[r1]++;
+      counts[r2]++;
+      if (counts[r1] <= 4 && counts[r2] <= 4) {
+        short r = static_cast<short>(Evaluator::evaluateRanks(counts, 7));
+        pairRank[r1][r2] = r;
+        pairRank[r2][r1] = r;
+      }
+      counts[r1]--;
+      counts[r2]--;
+    }
+  }
+
+  // 2. A flush needs 3+ board cards of one suit (only one suit can have that)
+  int flushSuit = -1;
+  for (int s = 0; s < 4; s++) {
+    if (__builtin_popcount(board.suitMask(s)) >= 3)
+      flushSuit = s;
+  }
+
+  // 3. Fill every combo
+  ranks.fill(0);
+  for (int j = 1; j < 52; j++) {
+    Card b = cardFromIndex(j);
+    if (board.contains(b))
+      continue;
+
+    for (int i = 0; i < j; i++) {
+      Card a = cardFromIndex(i);
+      if (board.contains(a))
+        continue;
+
+      int r = pairRank[a.rank()][b.rank()];
+      if (flushSuit >= 0) {
+        unsigned mask = board.suitMask(flushSuit);
+        if (a.suit() == flushSuit)
+          mask |= 1u << a.rank();
+        if (b.suit() == flushSuit)
+          mask |= 1u << b.rank();
+
+        int flush = Evaluator::evaluateFlush(mask);
+        if (flush > 0 && flush < r)
+          r = flush;
+      }
+      ranks[j * (j - 1) / 2 + i] = static_cast<short>(r);
+    }
+  }
+}
+
+} // namespace poker
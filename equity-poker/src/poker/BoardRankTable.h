@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Card.h"
+#include "CardSet.h"
+#include <array>
+#include <vector>
+
+namespace poker {
+
+// 7-card rank of every hole-card combo on one fixed river board
+// Built once (shared board work), then every query is a lookup:
+// showdowns, equity for any players, ranges...
+class BoardRankTable {
+public:
+  static const int NUM_COMBOS = 1326; // 52 choose 2
+
+  // board must be exactly 5 distinct cards
+  explicit BoardRankTable(const std::vector<Card> &board);
+
+  // Card index 0..51 (Rank * 4 + Suit) and combo index 0..1325
+  static int cardIndex(const Card &c) { return c.rank() * 4 + c.suit(); }
+  static Card cardFromIndex(int idx) { return Card(idx / 4, idx % 4); }
+  static int comboIndex(const Card &a, const Card &b);
+  static void comboCards(int combo, Card &a, Card &b);
+
+  // Rank (1 = Royal Flush), or 0 if the combo uses a board card
+  int rank(int combo) const { return ranks[combo]; }
+  int rank(const Card &a, const Card &b) const {
+    return ranks[comboIndex(a, b)];
+  }
+
+  const CardSet &getBoard() const { return board; }
+
+private:
+  CardSet board;
+  std::array<short, NUM_COMBOS> ranks;
+};
+
+} // namespace poker
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Card.h"
+#include <cstdint>
+#include <vector>
+
+namespace poker {
+
+// A set of cards packed in one 64-bit word (no allocations)
+// Bit index = Card::val (suit << 4 | rank), so each suit gets its own
+// 16-bit lane and the low 13 bits of a lane are that suit's rank mask.
+// Only 52 bits are ever used.
+class CardSet {
+public:
+  constexpr CardSet() : bits(0) {}
+  constexpr explicit CardSet(uint64_t b) : bits(b) {}
+
+  static CardSet fromCards(const std::vector<Card> &cards) {
+    CardSet set;
+    for (const auto &c : cards)
+      set.add(c);
+    return set;
+  }
+
+  // All 52 cards
+  static constexpr CardSet fullDeck() {
+    return CardSet(0x1FFF1FFF1FFF1FFFULL);
+  }
+
+  static constexpr uint64_t bit(const Card &c) { return 1ULL << c.val; }
+
+  void add(const Card &c) { bits |= bit(c); }
+  void remove(const Card &c) { bits &= ~bit(c); }
+  bool contains(const Card &c) const { return (bits & bit(c)) != 0; }
+
+  int size() const { return __builtin_popcountll(bits); }
+  bool empty() const { return bits == 0; }
+  uint64_t raw() const { return bits; }
+
+  // 13-bit rank mask of one suit
+  unsigned suitMask(int suit) const { return (bits >> (16 * suit)) & 0x1FFF; }
+
+  // Set operations
+  CardSet operator|(CardSet o) const { return CardSet(bits | o.bits); }
+  CardSet operator&(CardSet o) const { return CardSet(bits & o.bits); }
+  CardSet operator-(CardSet o) const { return CardSet(bits & ~o.bits); }
+  CardSet &operator|=(CardSet o) {
+    bits |= o.bits;
+    return *this;
+  }
+  CardSet &operator-=(CardSet o) {
+    bits &= ~o.bits;
+    return *this;
+  }
+  bool operator==(CardSet o) const { return bits == o.bits; }
+  bool operator!=(CardSet o) const { return bits != o.bits; }
+
+  // Iterate cards from lowest bit up: for (Card c : set) { ... }
+  class iterator {
+  public:
+    explicit iterator(uint64_t b) : rest(b) {}
+    Card operator*() const {
+      return Card(static_cast<uint8_t>(__builtin_ctzll(rest)));
+    }
+    iterator &operator++() {
+      rest &= rest - 1; // drop lowest card
+      return *this;
+    }
+    bool operator!=(const iterator &o) const { return rest != o.rest; }
+
+  private:
+    uint64_t rest;
+  };
+
+  iterator begin() const { return iterator(bits); }
+  iterator end() const { return iterator(0); }
+
+private:
+  uint64_t bits;
+};
+
+} // namespace poker
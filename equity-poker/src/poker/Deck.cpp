@@ -4,26 +4,24 @@
 
 namespace poker {
 
-Deck::Deck() {
+Deck::Deck(bool shortDeck) : shortDeck(shortDeck) { fill(); }
+
+void Deck::fill() {
+  cards.clear();
   cards.reserve(52); // optimise memory allocation
-  // Loop Ranks (0-12) and Suits (0-3)
+  // Loop Ranks (0-12, short deck from the 6) and Suits (0-3)
+  int lowest = shortDeck ? Card::RANK_6 : Card::RANK_2;
   for (int s = 0; s < 4; s++) {
-    for (int r = 0; r < 13; r++) {
+    for (int r = lowest; r < 13; r++) {
       cards.emplace_back(r, s);
     }
   }
 }
 
 void Deck::shuffle(std::mt19937 &rng) {
-  if (cards.size() < 52) {
-    // If cards were dealt, we need to reset before shuffling
-    cards.clear();
-    for (int s = 0; s < 4; s++) {
-      for (int r = 0; r < 13; r++) {
-        cards.emplace_back(r, s);
-      }
-    }
-  }
+  // If cards were dealt, we need to reset before shuffling
+  if (cards.size() < (shortDeck ? 36u : 52u))
+    fill();
   std::shuffle(cards.begin(), cards.end(), rng);
 }
 
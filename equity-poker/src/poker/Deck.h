@@ -8,10 +8,10 @@
 
 namespace poker {
 
-// Basic 52-card deck
+// Basic 52-card deck, or the 36-card short deck (6 to Ace)
 class Deck {
 public:
-  Deck();
+  explicit Deck(bool shortDeck = false);
 
   // Shuffle using a random number generator
   void shuffle(std::mt19937 &rng);
@@ -25,8 +25,19 @@ public:
   // get remaining cards (needed for equity calc)
   std::vector<Card> getCards() const { return cards; }
 
+  // the card deal() gives next, without dealing it (false if empty)
+  bool peek(Card &card) const {
+    if (cards.empty())
+      return false;
+    card = cards.back();
+    return true;
+  }
+
 private:
+  void fill();
+
   std::vector<Card> cards; // the deck
+  bool shortDeck;
 };
 
 } // namespace poker
@@ -0,0 +1,258 @@
+#include "EquityCache.h"
+#include "Range.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+namespace poker {
+
+using namespace std;
+
+EquityCache::EquityCache(size_t capacity) : results(capacity) {}
+
+EquityCache &EquityCache::instance() {
+  // A few thousand spots is hours of play across many rooms
+  static EquityCache cache(4096);
+  return cache;
+}
+
+// Card index 0..51 (Rank * 4 + Suit) with the suits renamed
+static unsigned char mapCard(const Card &c, const array<int, 4> &suitMap) {
+  return c.rank() * 4 + suitMap[c.suit()];
+}
+
+string EquityCache::canonicalKey(const vector<vector<Card>> &hands,
+                                 const vector<Card> &board,
+                                 vector<int> &order,
+                                 const vector<Card> &dead) {
+  const int numPlayers = hands.size();
+  string best;
+  array<int, 4> suitMap = {0, 1, 2, 3};
+
+  // Try all 24 suit renamings and keep the smallest encoding.
+  // Within one renaming, cards are sorted inside the board and each hand,
+  // and hands are sorted among themselves (player order is irrelevant).
+  do {
+    vector<unsigned char> boardBytes;
+    for (const auto &c : board)
+      boardBytes.push_back(mapCard(c, suitMap));
+    sort(boardBytes.begin(), boardBytes.end());
+
+    vector<pair<vector<unsigned char>, int>> handBytes(numPlayers);
+    for (int p = 0; p < numPlayers; p++) {
+      for (const auto &c : hands[p])
+        handBytes[p].first.push_back(mapCard(c, suitMap));
+      sort(handBytes[p].first.begin(), handBytes[p].first.end());
+      handBytes[p].second = p;
+    }
+    sort(handBytes.begin(), handBytes.end());
+
+    vector<unsigned char> deadBytes;
+    for (const auto &c : dead)
+      deadBytes.push_back(mapCard(c, suitMap));
+    sort(deadBytes.begin(), deadBytes.end());
+
+    // 0xFE / 0xFF never are cards, so they separate the groups
+    string key(boardBytes.begin(), boardBytes.end());
+    if (!deadBytes.empty()) {
+      key += '\xFE';
+      key.append(deadBytes.begin(), deadBytes.end());
+    }
+    for (const auto &hand : handBytes) {
+      key += '\xFF';
+      key.append(hand.first.begin(), hand.first.end());
+    }
+
+    if (best.empty() || key < best) {
+      best = key;
+      order.assign(numPlayers, 0);
+      for (int slot = 0; slot < numPlayers; slot++)
+        order[handBytes[slot].second] = slot;
+    }
+  } while (next_permutation(suitMap.begin(), suitMap.end()));
+
+  return best;
+}
+
+// Applies one permutation to every per-player field
+// (the breakdown fields may be empty: PreflopTable answers)
+template <typename Move>
+static EquityResult permute(const EquityResult &in, size_t numPlayers,
+                            Move &&move) {
+  EquityResult out = in;
+  auto apply = [&](auto &dst, const auto &src) {
+    if (src.size() != numPlayers)
+      return;
+    for (size_t p = 0; p < numPlayers; p++)
+      move(dst, src, p);
+  };
+  apply(out.equities, in.equities);
+  apply(out.stdErrors, in.stdErrors);
+  apply(out.ciLow, in.ciLow);
+  apply(out.ciHigh, in.ciHigh);
+  apply(out.winRates, in.winRates);
+  apply(out.tieRates, in.tieRates);
+  apply(out.categories, in.categories);
+  return out;
+}
+
+// Reorders every per-player field: out[to[p]] = in[p]
+static EquityResult reorder(const EquityResult &in, const vector<int> &to) {
+  return permute(in, to.size(), [&](auto &dst, const auto &src, size_t p) {
+    dst[to[p]] = src[p];
+  });
+}
+
+// Inverse of reorder: out[p] = in[from[p]]
+static EquityResult restore(const EquityResult &in, const vector<int> &from) {
+  return permute(in, from.size(), [&](auto &dst, const auto &src, size_t p) {
+    dst[p] = src[from[p]];
+  });
+}
+
+// Different sampling settings give different answers (the seed does not:
+// any sample is as good as another)
+static string optionsKey(const EquityOptions &options) {
+  return to_string(options.maxIterations) + ":" +
+         to_string(options.targetPrecision) + ":" +
+         to_string(options.timeBudgetMs) + ":" +
+         to_string(options.forceExact) + ":" +
+         to_string(options.shortDeck) + ":" +
+         to_string(options.usePreflopTable);
+}
+
+bool EquityCache::lookup(const string &key, EquityResult &result) {
+  lock_guard<mutex> lock(mtx);
+  if (!results.get(key, result)) {
+    misses++;
+    return false;
+  }
+  hits++;
+  return true;
+}
+
+void EquityCache::store(const string &key, const EquityResult &result) {
+  // Abandoned jobs are incomplete, never keep them
+  if (result.cancelled)
+    return;
+
+  lock_guard<mutex> lock(mtx);
+  results.put(key, result);
+}
+
+EquityResult EquityCache::calculate(const vector<vector<Card>> &hands,
+                                    const vector<Card> &board,
+                                    const EquityOptions &options) {
+  vector<int> order;
+  string key = canonicalKey(hands, board, order, options.deadCards) + '\xFF' +
+               optionsKey(options);
+
+  EquityResult cached;
+  if (lookup(key, cached))
+    return restore(cached, order);
+
+  // Compute outside the lock so other rooms are not blocked; two rooms
+  // missing on the same spot at once just both compute it
+  EquityResult result = EquityCalculator::calculate(hands, board, options);
+  store(key, reorder(result, order));
+  return result;
+}
+
+vector<EquityResult>
+EquityCache::solveBatch(const vector<string> &keys,
+                        const function<EquityResult(size_t)> &compute) {
+  vector<EquityResult> results(keys.size());
+
+  // Cached or duplicate keys first
+  vector<size_t> toCompute;
+  unordered_map<string, size_t> firstWithKey;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (firstWithKey.count(keys[i]))
+      continue;
+    firstWithKey[keys[i]] = i;
+    if (!lookup(keys[i], results[i]))
+      toCompute.push_back(i);
+  }
+
+  // One parallel pass over the distinct new problems (each one still
+  // spreads its own work over the pool)
+  ThreadPool::instance().parallelFor(
+      toCompute.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++)
+          results[toCompute[t]] = compute(toCompute[t]);
+      });
+
+  for (size_t i : toCompute)
+    store(keys[i], results[i]);
+  for (size_t i = 0; i < keys.size(); i++)
+    results[i] = results[firstWithKey[keys[i]]];
+  return results;
+}
+
+vector<EquityResult>
+EquityCache::calculateBatch(const vector<EquityProblem> &problems,
+                            const EquityOptions &options) {
+  vector<string> keys(problems.size());
+  vector<vector<int>> orders(problems.size());
+  for (size_t i = 0; i < problems.size(); i++) {
+    const EquityProblem &problem = problems[i];
+    keys[i] = canonicalKey(problem.hands, problem.board, orders[i],
+                           problem.deadCards) +
+              '\xFF' + optionsKey(options);
+  }
+
+  // Solved in canonical player order, so isomorphic problems share
+  vector<EquityResult> results =
+      solveBatch(keys, [&](size_t i) {
+        EquityOptions problemOptions = options;
+        problemOptions.deadCards = problems[i].deadCards;
+        problemOptions.onProgress = nullptr;
+        EquityResult result = EquityCalculator::calculate(
+            problems[i].hands, problems[i].board, problemOptions);
+        return reorder(result, orders[i]);
+      });
+
+  for (size_t i = 0; i < problems.size(); i++)
+    results[i] = restore(results[i], orders[i]);
+  return results;
+}
+
+vector<EquityResult>
+EquityCache::calculateVsRandom(const vector<vector<Card>> &hands,
+                               const vector<Card> &board,
+                               const vector<int> &opponents,
+                               const EquityOptions &options) {
+  // "R" keeps these apart from known-hand spots
+  vector<string> keys(hands.size());
+  for (size_t i = 0; i < hands.size(); i++) {
+    vector<int> order;
+    keys[i] = "R" + to_string(opponents[i]) + '\xFF' +
+              canonicalKey({hands[i]}, board, order, options.deadCards) +
+              '\xFF' + optionsKey(options);
+  }
+
+  return solveBatch(keys, [&](size_t i) {
+    vector<Range> randomHands(opponents[i], Range::all());
+    return EquityCalculator::calculateVsRanges(hands[i], randomHands, board,
+                                               options);
+  });
+}
+
+EquityCache::Stats EquityCache::stats() const {
+  lock_guard<mutex> lock(mtx);
+  Stats s;
+  s.hits = hits;
+  s.misses = misses;
+  s.size = results.size();
+  return s;
+}
+
+void EquityCache::clear() {
+  lock_guard<mutex> lock(mtx);
+  results.clear();
+  hits = 0;
+  misses = 0;
+}
+
+} // namespace poker
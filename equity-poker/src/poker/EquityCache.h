@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Card.h"
+#include "EquityCalculator.h"
+#include "LruCache.h"
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace poker {
+
+// One independent equity problem of a batch
+struct EquityProblem {
+  std::vector<std::vector<Card>> hands;
+  std::vector<Card> board;
+  std::vector<Card> deadCards;
+};
+
+// LRU cache of equity results
+// Spots that only differ by suit renaming (AsKs vs AhKh on a rainbow board)
+// or by player order share one entry, so repeated broadcasts of an
+// unchanged table and isomorphic spots in other rooms are a single lookup.
+class EquityCache {
+public:
+  struct Stats {
+    long long hits = 0;
+    long long misses = 0;
+    size_t size = 0;
+  };
+
+  explicit EquityCache(size_t capacity);
+
+  // Process-wide cache shared by every room
+  static EquityCache &instance();
+
+  // Cached EquityCalculator::calculate (results in the caller's player
+  // order). Sampled results are cached too: a repeat returns the same
+  // numbers instead of fresh noise.
+  EquityResult calculate(const std::vector<std::vector<Card>> &hands,
+                         const std::vector<Card> &board,
+                         const EquityOptions &options = EquityOptions());
+
+  // Many problems at once (e.g. every room's pending work), results in
+  // order. Identical or isomorphic problems are solved once and the rest
+  // run together in one pass over the pool. options apply to all of them,
+  // except deadCards (per problem) and onProgress (not called).
+  std::vector<EquityResult>
+  calculateBatch(const std::vector<EquityProblem> &problems,
+                 const EquityOptions &options = EquityOptions());
+
+  // Equity of each hand against opponents[i] random hands (only the hand
+  // and the board are dead: nobody else's cards are known). Distinct
+  // spots among the hands are computed once, all in one parallel pass.
+  // Result i: hands[i] is player 0, then the random opponents
+  std::vector<EquityResult>
+  calculateVsRandom(const std::vector<std::vector<Card>> &hands,
+                    const std::vector<Card> &board,
+                    const std::vector<int> &opponents,
+                    const EquityOptions &options = EquityOptions());
+
+  Stats stats() const;
+  void clear();
+
+  // Canonical form of a spot, exposed for tests
+  // - key: same for every suit renaming / player order of the spot
+  // - order[p]: where player p ends up in the canonical order
+  // - dead: EquityOptions::deadCards, renamed along with everything else
+  static std::string canonicalKey(const std::vector<std::vector<Card>> &hands,
+                                  const std::vector<Card> &board,
+                                  std::vector<int> &order,
+                                  const std::vector<Card> &dead = {});
+
+private:
+  bool lookup(const std::string &key, EquityResult &result);
+  void store(const std::string &key, const EquityResult &result);
+  // Result for every key: cached, shared with an earlier equal key, or
+  // compute(i) (run in parallel, stored as returned)
+  std::vector<EquityResult>
+  solveBatch(const std::vector<std::string> &keys,
+             const std::function<EquityResult(size_t)> &compute);
+
+  mutable std::mutex mtx;
+  LruCache<std::string, EquityResult> results;
+  long long hits = 0;
+  long long misses = 0;
+};
+
+} // namespace poker
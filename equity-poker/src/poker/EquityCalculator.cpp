@@ -1,91 +1,240 @@
 #include "EquityCalculator.h"
+#include "BoardRankTable.h"
+#include "CardSet.h"
 #include "Deck.h"
 #include "Evaluator.h"
+#include "PreflopTable.h"
+#include "Range.h"
+#include "Random.h"
+#include "ShortDeckEvaluator.h"
+#include "ThreadPool.h"
 #include <algorithm>
-#include <future>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <random>
-#include <thread>
+#include <stdexcept>
 #include <vector>
 
 namespace poker {
 
 using namespace std;
 
-// Helper to run a chunk of simulations
-static vector<double> runSimulations(int iterations,
-                                     const vector<vector<Card>> &hands,
-                                     const vector<Card> &board,
-                                     const vector<Card> &deck) {
+// Hands handed to the batch evaluator per call
+static const int kBatchHands = 16;
 
-  int numPlayers = hands.size();
-  vector<double> wins(numPlayers, 0.0);
+// Boards with at most this many runouts are enumerated exactly
+// (never more work than the 100k random samples)
+static const long long kExactRunoutLimit = 100000;
+
+// Number of ways to deal k cards from n
+static long long countRunouts(int n, int k) {
+  long long total = 1;
+  for (int i = 0; i < k; i++)
+    total = total * (n - i) / (i + 1);
+  return total;
+}
 
-  // Local RNG for this thread
-  random_device rd;
-  mt19937 rng(rd());
+// 95% confidence interval = equity +/- Z * standard error
+static const double kZ95 = 1.96;
 
-  // Local copy of deck to shuffle
-  vector<Card> currentDeck = deck;
+// Per-player totals for a chunk of runouts
+struct Tally {
+  vector<double> share;   // sum of pot shares (1 = win, 1/k = k-way split)
+  vector<double> shareSq; // sum of squared shares (for the standard error)
+  vector<double> wins;    // runouts won outright
+  vector<double> ties;    // runouts split
+  vector<array<double, NUM_HAND_CATEGORIES>> categories;
 
-  // Buffers for 7 cards per player
-  vector<vector<Card>> playerHandCards(numPlayers);
-  for (int i = 0; i < numPlayers; i++) {
-    playerHandCards[i].reserve(7);
+  explicit Tally(int numPlayers)
+      : share(numPlayers, 0.0), shareSq(numPlayers, 0.0),
+        wins(numPlayers, 0.0), ties(numPlayers, 0.0),
+        categories(numPlayers) {
+    for (auto &c : categories)
+      c.fill(0.0);
   }
 
-  // Simulation Loop
-  for (int i = 0; i < iterations; i++) {
-    // 1. Shuffle remaining deck
-    shuffle(currentDeck.begin(), currentDeck.end(), rng);
+  // One runout for player p (w: weight of the deal, ranges only)
+  void record(int p, double s, HandCategory category, double w = 1.0) {
+    share[p] += w * s;
+    shareSq[p] += w * s * s;
+    if (s == 1.0)
+      wins[p] += w;
+    else if (s > 0.0)
+      ties[p] += w;
+    categories[p][static_cast<int>(category)] += w;
+  }
 
-    // 2. Deal missing board cards
-    int cardsNeeded = 5 - board.size();
+  void add(const Tally &other) {
+    for (size_t p = 0; p < share.size(); p++) {
+      share[p] += other.share[p];
+      shareSq[p] += other.shareSq[p];
+      wins[p] += other.wins[p];
+      ties[p] += other.ties[p];
+      for (int c = 0; c < NUM_HAND_CATEGORIES; c++)
+        categories[p][c] += other.categories[p][c];
+    }
+  }
+};
 
-    // 3. Evaluate each player
+// Calls award(deal, player, share, rank) for every player of count deals
+// already ranked (ranks[d * numPlayers + p]); share is 0 for the losers,
+// split pots share evenly
+template <typename Award>
+static void awardRanks(const int *ranks, int count, int numPlayers,
+                       Award &&award) {
+  for (int b = 0; b < count; b++) {
+    const int *playerRanks = &ranks[b * numPlayers];
     int bestRank = 9999;
-    vector<int> playerRanks(numPlayers);
-
     for (int p = 0; p < numPlayers; p++) {
-      // Construct full hand: Hole Cards + Board + Dealt Board
-      playerHandCards[p] = hands[p];
-      playerHandCards[p].insert(playerHandCards[p].end(), board.begin(),
-                                board.end());
-
-      // Add random cards from deck for the rest of the board
-      for (int k = 0; k < cardsNeeded; k++) {
-        playerHandCards[p].push_back(currentDeck[k]);
-      }
-
-      playerRanks[p] = Evaluator::evaluate(playerHandCards[p]);
       if (playerRanks[p] < bestRank)
         bestRank = playerRanks[p];
     }
 
-    // 4. Award wins (handle splits/ties)
+    // Award wins (handle splits/ties)
     int winners = 0;
-    for (int r : playerRanks) {
-      if (r == bestRank)
+    for (int p = 0; p < numPlayers; p++) {
+      if (playerRanks[p] == bestRank)
         winners++;
     }
 
     double winShare = 1.0 / winners;
     for (int p = 0; p < numPlayers; p++) {
-      if (playerRanks[p] == bestRank) {
-        wins[p] += winShare;
-      }
+      award(b, p, playerRanks[p] == bestRank ? winShare : 0.0,
+            playerRanks[p]);
     }
   }
+}
 
-  return wins;
+// Evaluates count deals of numPlayers hands (hands[d * numPlayers + p])
+// and awards them as above
+template <typename Award>
+static void awardHands(const CardSet *hands, int count, int numPlayers,
+                       vector<int> &blockRanks, Award &&award) {
+  // Evaluate every player of every deal in one go
+  Evaluator::evaluateBatch(hands, count * numPlayers, blockRanks.data());
+  awardRanks(blockRanks.data(), count, numPlayers,
+             std::forward<Award>(award));
 }
 
-vector<double>
-EquityCalculator::calculateEquity(const vector<vector<Card>> &hands,
-                                  const vector<Card> &board) {
+// Known hands for the runout loops
+// Hold'em: hole cards + known board, one 7-card evaluation per runout
+// (short deck: same with ShortDeckEvaluator)
+// Omaha: hole cards only, scored against an OmahaBoard per runout (the
+// 2 + 3 rule needs the two apart)
+struct KnownHands {
+  vector<CardSet> sets;
+  bool omaha = false;
+  bool shortDeck = false;
+  CardSet board;
 
-  // 1. Create the "Remaining Deck"
-  // Start with full deck, remove all hole cards and board cards
-  // 1. Create the "Remaining Deck"
+  int size() const { return static_cast<int>(sets.size()); }
+
+  HandCategory category(int rank) const {
+    return shortDeck ? ShortDeckEvaluator::category(rank)
+                     : Evaluator::category(rank);
+  }
+};
+
+// Evaluates every player on each runout and awards the winners
+// - blockHands/blockRanks: scratch buffers (reused, no allocations)
+template <typename Award>
+static void awardRunouts(const CardSet *runouts, int count,
+                         const KnownHands &hands,
+                         vector<CardSet> &blockHands, vector<int> &blockRanks,
+                         Award &&award) {
+  int numPlayers = hands.size();
+  const vector<CardSet> &handSets = hands.sets;
+
+  if (hands.omaha) {
+    // Board subsets are worked out once per runout for every player
+    for (int b = 0; b < count; b++) {
+      OmahaBoard board(hands.board | runouts[b]);
+      for (int p = 0; p < numPlayers; p++)
+        blockRanks[b * numPlayers + p] = board.evaluate(handSets[p]);
+    }
+    awardRanks(blockRanks.data(), count, numPlayers,
+               std::forward<Award>(award));
+    return;
+  }
+
+  for (int b = 0; b < count; b++) {
+    for (int p = 0; p < numPlayers; p++) {
+      blockHands[b * numPlayers + p] = handSets[p] | runouts[b];
+    }
+  }
+
+  if (hands.shortDeck) {
+    ShortDeckEvaluator::evaluateBatch(blockHands.data(), count * numPlayers,
+                                      blockRanks.data());
+    awardRanks(blockRanks.data(), count, numPlayers,
+               std::forward<Award>(award));
+    return;
+  }
+  awardHands(blockHands.data(), count, numPlayers, blockRanks,
+             std::forward<Award>(award));
+}
+
+// Same, recording every runout in one tally
+static void scoreRunouts(const CardSet *runouts, int count,
+                         const KnownHands &hands,
+                         vector<CardSet> &blockHands, vector<int> &blockRanks,
+                         Tally &tally) {
+  awardRunouts(runouts, count, hands, blockHands, blockRanks,
+               [&](int, int p, double share, int rank) {
+                 tally.record(p, share, hands.category(rank));
+               });
+}
+
+// Several runouts go into one batch so the evaluator always sees
+// ~16 hands per call, even heads-up
+static int runoutsPerBlock(int numPlayers) {
+  return max(1, kBatchHands / numPlayers);
+}
+
+// 4 hole cards each: Omaha (2 Hold'em cards otherwise)
+static bool isOmaha(const vector<vector<Card>> &hands) {
+  size_t holeCards = hands.empty() ? 2 : hands[0].size();
+  for (const auto &hand : hands) {
+    if (hand.size() != holeCards || (holeCards != 2 && holeCards != 4))
+      throw invalid_argument("Every hand needs 2 (Hold'em) or 4 (Omaha) "
+                             "hole cards");
+  }
+  return holeCards == 4;
+}
+
+// Hands as bitmasks (built once, no per-iteration vectors)
+static KnownHands buildHandSets(const vector<vector<Card>> &hands,
+                                const vector<Card> &board, bool shortDeck) {
+  KnownHands known;
+  known.omaha = isOmaha(hands);
+  known.shortDeck = shortDeck;
+  known.board = CardSet::fromCards(board);
+  if (shortDeck) {
+    if (known.omaha)
+      throw invalid_argument("Short deck is Hold'em only");
+    CardSet all = known.board;
+    for (const auto &hand : hands)
+      all |= CardSet::fromCards(hand);
+    for (Card c : all) {
+      if (!ShortDeckEvaluator::inDeck(c))
+        throw invalid_argument("Not a short-deck card: " + c.toString());
+    }
+  }
+  known.sets.resize(hands.size());
+  for (size_t p = 0; p < hands.size(); p++) {
+    known.sets[p] = CardSet::fromCards(hands[p]);
+    if (!known.omaha)
+      known.sets[p] |= known.board;
+  }
+  return known;
+}
+
+// Full deck (or the short deck) minus hole cards, board and dead cards
+static vector<Card> buildRemainingDeck(const vector<vector<Card>> &hands,
+                                       const vector<Card> &board,
+                                       const vector<Card> &dead,
+                                       bool shortDeck = false) {
   // Optimisation: Use a boolean array to mark used cards (Rank * 4 + Suit)
   // 13 ranks * 4 suits = 52 cards
   bool usedCards[52] = {false};
@@ -103,12 +252,16 @@ EquityCalculator::calculateEquity(const vector<vector<Card>> &hands,
     usedCards[idx] = true;
   }
 
+  for (const auto &card : dead) {
+    int idx = card.rank() * 4 + card.suit();
+    usedCards[idx] = true;
+  }
+
   // Rebuild the deck
-  Deck fullDeck;
-  std::vector<Card> remainingDeck;
-  remainingDeck.reserve(52 - (hands.size() * 2 + board.size()));
+  vector<Card> remainingDeck;
+  remainingDeck.reserve(52);
 
-  for (int r = 0; r < 13; r++) {
+  for (int r = shortDeck ? Card::RANK_6 : 0; r < 13; r++) {
     for (int s = 0; s < 4; s++) {
       int idx = r * 4 + s;
       if (!usedCards[idx]) {
@@ -116,39 +269,536 @@ EquityCalculator::calculateEquity(const vector<vector<Card>> &hands,
       }
     }
   }
+  return remainingDeck;
+}
+
+// Helper to run a chunk of simulations
+// Inputs are shared by every chunk and never copied
+static void runSimulations(int iterations, const KnownHands &hands,
+                           int cardsNeeded, const vector<Card> &deck,
+                           FastRng &rng, Tally &tally) {
+  int numPlayers = hands.size();
+
+  // Local copy of deck to draw from
+  vector<Card> currentDeck = deck;
+
+  const int blockRunouts = runoutsPerBlock(numPlayers);
+  vector<CardSet> runouts(blockRunouts);
+  vector<CardSet> blockHands(blockRunouts * numPlayers);
+  vector<int> blockRanks(blockHands.size());
+
+  // Simulation Loop
+  for (int done = 0; done < iterations; done += blockRunouts) {
+    int blockSize = min(blockRunouts, iterations - done);
+
+    // 1 + 2. Draw only the missing board cards (partial Fisher-Yates)
+    for (int b = 0; b < blockSize; b++) {
+      runouts[b] = drawCards(currentDeck.data(), currentDeck.size(),
+                             cardsNeeded, rng);
+    }
 
-  // 2. Multithreading Setup
-  int totalIterations = 100000; // 100k sims
-  int numThreads = thread::hardware_concurrency();
-  if (numThreads == 0)
-    numThreads = 4;
+    // 3 + 4. Evaluate and award wins
+    scoreRunouts(runouts.data(), blockSize, hands, blockHands, blockRanks,
+                 tally);
+  }
+}
 
-  int simsPerThread = totalIterations / numThreads;
+// Every way to deal k more board cards from the deck
+static void collectRunouts(const vector<Card> &deck, int k, size_t start,
+                           CardSet current, vector<CardSet> &out) {
+  if (k == 0) {
+    out.push_back(current);
+    return;
+  }
+  for (size_t i = start; i + k <= deck.size(); i++) {
+    CardSet next = current;
+    next.add(deck[i]);
+    collectRunouts(deck, k - 1, i + 1, next, out);
+  }
+}
 
-  vector<future<vector<double>>> futures;
+// Helper to score a slice [begin, end) of the enumerated runouts
+static void runEnumeration(const vector<CardSet> &allRunouts, size_t begin,
+                           size_t end, const KnownHands &hands,
+                           Tally &tally) {
+  int numPlayers = hands.size();
+  const int blockRunouts = runoutsPerBlock(numPlayers);
+  vector<CardSet> blockHands(blockRunouts * numPlayers);
+  vector<int> blockRanks(blockHands.size());
 
-  // 3. Launch Threads
-  for (int i = 0; i < numThreads; i++) {
-    futures.push_back(async(launch::async, runSimulations, simsPerThread, hands,
-                            board, remainingDeck));
+  for (size_t i = begin; i < end; i += blockRunouts) {
+    int blockSize = min<size_t>(blockRunouts, end - i);
+    scoreRunouts(&allRunouts[i], blockSize, hands, blockHands, blockRanks,
+                 tally);
   }
+}
+
+// Turns totals over n runouts into equities + confidence intervals
+// (exact results have no sampling error)
+static EquityResult makeResult(const Tally &tally, long long n, bool exact) {
+  EquityResult result;
+  result.iterations = n;
+  result.exact = exact;
 
-  // 4. Aggregate Results
-  vector<double> totalWins(hands.size(), 0.0);
-  for (auto &f : futures) {
-    vector<double> threadWins = f.get();
-    for (size_t p = 0; p < hands.size(); p++) {
-      totalWins[p] += threadWins[p];
+  for (size_t p = 0; p < tally.share.size(); p++) {
+    double mean = n > 0 ? tally.share[p] / n : 0.0;
+    double stdErr = 0.0;
+    if (!exact && n > 1) {
+      double variance = max(0.0, tally.shareSq[p] / n - mean * mean);
+      stdErr = sqrt(variance / n);
     }
+
+    result.equities.push_back(mean);
+    result.stdErrors.push_back(stdErr);
+    result.ciLow.push_back(max(0.0, mean - kZ95 * stdErr));
+    result.ciHigh.push_back(min(1.0, mean + kZ95 * stdErr));
+
+    array<double, NUM_HAND_CATEGORIES> categories;
+    for (int c = 0; c < NUM_HAND_CATEGORIES; c++)
+      categories[c] = n > 0 ? tally.categories[p][c] / n : 0.0;
+    result.winRates.push_back(n > 0 ? tally.wins[p] / n : 0.0);
+    result.tieRates.push_back(n > 0 ? tally.ties[p] / n : 0.0);
+    result.categories.push_back(categories);
   }
+  return result;
+}
+
+static bool isCancelled(const EquityOptions &options) {
+  return options.cancel && options.cancel->load(memory_order_relaxed);
+}
+
+// Widest 95% interval half-width across players
+static double worstPrecision(const EquityResult &result) {
+  double worst = 0.0;
+  for (double se : result.stdErrors)
+    worst = max(worst, kZ95 * se);
+  return worst;
+}
+
+// Sampling in rounds across the pool, checking after each round whether
+// we are precise enough (or out of time) to stop early.
+// Rounds start at one chunk and double, so a coarse estimate is ready
+// almost immediately.
+// Chunk k always uses RNG stream k and chunks are summed in order, so
+// a fixed seed gives the same answer however chunks land on threads.
+// - runChunk(iterations, rng, tally): samples one chunk
+template <typename RunChunk>
+static EquityResult sampleInRounds(int numPlayers,
+                                   const EquityOptions &options,
+                                   RunChunk &&runChunk) {
+  ThreadPool &pool = ThreadPool::instance();
+  const int iterationsPerChunk = 4096;
+  const int chunksPerRound = max(4, pool.size());
+  uint64_t seed = options.seed;
+  if (seed == 0)
+    seed = (static_cast<uint64_t>(random_device{}()) << 32) ^ random_device{}();
+
+  auto started = chrono::steady_clock::now();
+  Tally total(numPlayers);
+  long long done = 0;
+  FastRng streams(seed); // the next chunk's stream, carried across rounds
+  int roundSize = 1;
+  EquityResult result = makeResult(total, 0, false);
+
+  while (done < options.maxIterations) {
+    if (isCancelled(options)) {
+      result.cancelled = true;
+      break;
+    }
+
+    long long roundIterations =
+        min<long long>(roundSize * iterationsPerChunk,
+                       options.maxIterations - done);
+    roundSize = min(roundSize * 2, chunksPerRound);
+    size_t roundChunks =
+        (roundIterations + iterationsPerChunk - 1) / iterationsPerChunk;
+
+    vector<Tally> chunkTallies(roundChunks, Tally(numPlayers));
+    vector<FastRng> rngs;
+    rngs.reserve(roundChunks);
+    for (size_t c = 0; c < roundChunks; c++)
+      rngs.push_back(streams.nextStream());
+    pool.parallelFor(roundIterations, iterationsPerChunk,
+                     [&](size_t begin, size_t end) {
+                       size_t chunk = begin / iterationsPerChunk;
+                       runChunk(end - begin, rngs[chunk],
+                                chunkTallies[chunk]);
+                     });
 
-  // 5. Convert to Percentage (0.0 - 1.0)
-  vector<double> equities;
-  for (double w : totalWins) {
-    equities.push_back(w / totalIterations);
+    for (const auto &t : chunkTallies)
+      total.add(t);
+    done += roundIterations;
+    result = makeResult(total, done, false);
+
+    // Stop once precise enough or out of time
+    bool precise = options.targetPrecision > 0 &&
+                   worstPrecision(result) <= options.targetPrecision;
+    bool outOfTime = options.timeBudgetMs > 0 &&
+                     chrono::steady_clock::now() - started >=
+                         chrono::milliseconds(options.timeBudgetMs);
+    if (precise || outOfTime || done >= options.maxIterations)
+      break;
+
+    if (options.onProgress)
+      options.onProgress(result);
+  }
+
+  return result;
+}
+
+vector<double>
+EquityCalculator::calculateEquity(const vector<vector<Card>> &hands,
+                                  const vector<Card> &board) {
+  return calculate(hands, board, EquityOptions()).equities;
+}
+
+vector<double>
+EquityCalculator::calculateEquity(const vector<vector<Card>> &hands,
+                                  const vector<Card> &board,
+                                  const EquityOptions &options) {
+  return calculate(hands, board, options).equities;
+}
+
+EquityResult EquityCalculator::calculate(const vector<vector<Card>> &hands,
+                                         const vector<Card> &board,
+                                         const EquityOptions &options) {
+  // Nobody to score (an empty result, as calculateEquity always gave)
+  if (hands.empty())
+    return EquityResult();
+
+  // 1. Create the "Remaining Deck"
+  vector<Card> remainingDeck = buildRemainingDeck(
+      hands, board, options.deadCards, options.shortDeck);
+
+  int numPlayers = hands.size();
+  KnownHands known = buildHandSets(hands, board, options.shortDeck);
+
+  // River: nothing left to deal, so look the ranks up once instead of
+  // simulating the same board 100k times
+  if (board.size() == 5) {
+    vector<int> ranks;
+    if (known.omaha) {
+      OmahaBoard table(known.board);
+      for (CardSet hole : known.sets)
+        ranks.push_back(table.evaluate(hole));
+    } else if (known.shortDeck) {
+      for (CardSet hand : known.sets)
+        ranks.push_back(ShortDeckEvaluator::evaluate(hand));
+    } else {
+      BoardRankTable table(board);
+      for (const auto &hand : hands)
+        ranks.push_back(table.rank(hand[0], hand[1]));
+    }
+    // A plain loop rather than *min_element: well defined for any ranks
+    int bestRank = 9999;
+    for (int rank : ranks)
+      bestRank = min(bestRank, rank);
+
+    int winners = count(ranks.begin(), ranks.end(), bestRank);
+    Tally tally(numPlayers);
+    for (int p = 0; p < numPlayers; p++)
+      tally.record(p, ranks[p] == bestRank ? 1.0 / winners : 0.0,
+                   known.category(ranks[p]));
+    return makeResult(tally, 1, true);
+  }
+
+  int cardsNeeded = 5 - board.size();
+
+  // Heads-up preflop: precomputed offline, one lookup (the table assumes
+  // every other card can still come)
+  if (board.empty() && numPlayers == 2 && !known.omaha &&
+      !known.shortDeck && options.usePreflopTable &&
+      options.deadCards.empty() && !options.forceExact) {
+    const PreflopTable *table = PreflopTable::instance();
+    double equity = table ? table->equity(hands[0][0], hands[0][1],
+                                          hands[1][0], hands[1][1])
+                          : -1.0;
+    if (equity >= 0) {
+      Tally tally(numPlayers);
+      tally.share = {equity, 1.0 - equity};
+      EquityResult result = makeResult(tally, 1, true);
+      result.iterations = countRunouts(remainingDeck.size(), cardsNeeded);
+      result.winRates.clear();
+      result.tieRates.clear();
+      result.categories.clear();
+      return result;
+    }
+  }
+
+  ThreadPool &pool = ThreadPool::instance();
+
+  // Flop / Turn: few enough runouts to enumerate them all (exact, no noise)
+  if (countRunouts(remainingDeck.size(), cardsNeeded) <= kExactRunoutLimit ||
+      options.forceExact) {
+    vector<CardSet> allRunouts;
+    collectRunouts(remainingDeck, cardsNeeded, 0, CardSet(), allRunouts);
+
+    // Small jobs stay on one thread (chunks of ~20k evaluations)
+    size_t chunk = max<size_t>(1, 20000 / numPlayers);
+    vector<Tally> chunkTallies((allRunouts.size() + chunk - 1) / chunk,
+                               Tally(numPlayers));
+    pool.parallelFor(allRunouts.size(), chunk, [&](size_t begin, size_t end) {
+      if (isCancelled(options))
+        return;
+      runEnumeration(allRunouts, begin, end, known,
+                     chunkTallies[begin / chunk]);
+    });
+
+    Tally total(numPlayers);
+    for (const auto &t : chunkTallies)
+      total.add(t);
+    EquityResult result = makeResult(total, allRunouts.size(), true);
+    result.cancelled = isCancelled(options);
+    return result;
   }
 
-  return equities;
+  // 2. Too many runouts to enumerate (preflop): sample
+  return sampleInRounds(numPlayers, options,
+                        [&](int iterations, FastRng &rng, Tally &tally) {
+                          runSimulations(iterations, known, cardsNeeded,
+                                         remainingDeck, rng, tally);
+                        });
+}
+
+vector<EquityResult>
+EquityCalculator::calculateNextCard(const vector<vector<Card>> &hands,
+                                    const vector<Card> &board,
+                                    const EquityOptions &options) {
+  if (board.size() != 3 && board.size() != 4)
+    throw invalid_argument("calculateNextCard needs a flop or a turn");
+  if (hands.empty())
+    return vector<EquityResult>(52);
+
+  int numPlayers = hands.size();
+  vector<Card> remainingDeck = buildRemainingDeck(
+      hands, board, options.deadCards, options.shortDeck);
+  KnownHands known = buildHandSets(hands, board, options.shortDeck);
+
+  vector<CardSet> allRunouts;
+  collectRunouts(remainingDeck, 5 - board.size(), 0, CardSet(), allRunouts);
+
+  // Every runout is scored once and counts for each of its cards:
+  // turn + river on the flop, just the river on the turn
+  vector<Tally> perCard(52, Tally(numPlayers));
+  vector<long long> runoutsPerCard(52, 0);
+  const int blockRunouts = runoutsPerBlock(numPlayers);
+  vector<CardSet> blockHands(blockRunouts * numPlayers);
+  vector<int> blockRanks(blockHands.size());
+
+  for (size_t i = 0; i < allRunouts.size(); i += blockRunouts) {
+    if (isCancelled(options))
+      break;
+    int blockSize = min<size_t>(blockRunouts, allRunouts.size() - i);
+    const CardSet *block = &allRunouts[i];
+
+    awardRunouts(block, blockSize, known, blockHands, blockRanks,
+                 [&](int b, int p, double share, int rank) {
+                   for (Card c : block[b])
+                     perCard[c.rank() * 4 + c.suit()].record(
+                         p, share, known.category(rank));
+                 });
+    for (int b = 0; b < blockSize; b++) {
+      for (Card c : block[b])
+        runoutsPerCard[c.rank() * 4 + c.suit()]++;
+    }
+  }
+
+  vector<EquityResult> results(52);
+  for (int idx = 0; idx < 52; idx++) {
+    if (runoutsPerCard[idx] > 0)
+      results[idx] = makeResult(perCard[idx], runoutsPerCard[idx], true);
+    results[idx].cancelled = isCancelled(options);
+  }
+  return results;
+}
+
+// A range's combos that miss the board, ready to sample from
+struct RangeDeck {
+  vector<int> comboIds;
+  vector<CardSet> combos;
+  vector<double> weights;
+  vector<double> cumulative; // running weight total
+};
+
+// blocked: board and dead cards
+static vector<RangeDeck> buildRangeDecks(const vector<Range> &ranges,
+                                         CardSet blocked) {
+  vector<RangeDeck> decks(ranges.size());
+  for (size_t p = 0; p < ranges.size(); p++) {
+    RangeDeck &deck = decks[p];
+    double total = 0.0;
+    for (int combo = 0; combo < Range::NUM_COMBOS; combo++) {
+      double w = ranges[p].weight(combo);
+      Card a, b;
+      BoardRankTable::comboCards(combo, a, b);
+      CardSet set;
+      set.add(a);
+      set.add(b);
+      if (w <= 0.0 || !(set & blocked).empty())
+        continue;
+
+      total += w;
+      deck.comboIds.push_back(combo);
+      deck.combos.push_back(set);
+      deck.weights.push_back(w);
+      deck.cumulative.push_back(total);
+    }
+    if (deck.combos.empty())
+      throw invalid_argument("Range has no combos left on this board");
+  }
+  return decks;
+}
+
+// Gives up after this many clashing deals in a row
+static const int kMaxRedeals = 100000;
+
+// Picks one combo per player in proportion to the weights. Any clash
+// redeals everyone, which keeps the joint distribution exact.
+static bool dealCombos(const vector<RangeDeck> &decks, CardSet blocked,
+                       FastRng &rng, CardSet *holes, CardSet &used) {
+  for (int attempt = 0; attempt < kMaxRedeals; attempt++) {
+    used = blocked;
+    bool clash = false;
+    for (size_t p = 0; p < decks.size() && !clash; p++) {
+      const RangeDeck &deck = decks[p];
+      double u = (rng.next() >> 11) * 0x1.0p-53 * deck.cumulative.back();
+      size_t i = upper_bound(deck.cumulative.begin(), deck.cumulative.end(),
+                             u) -
+                 deck.cumulative.begin();
+      i = min(i, deck.combos.size() - 1);
+
+      clash = !(deck.combos[i] & used).empty();
+      holes[p] = deck.combos[i];
+      used |= holes[p];
+    }
+    if (!clash)
+      return true;
+  }
+  return false;
+}
+
+// Helper to run a chunk of range-vs-range simulations
+static void runRangeSimulations(int iterations, const vector<RangeDeck> &decks,
+                                CardSet boardSet, CardSet deadSet,
+                                int cardsNeeded, FastRng &rng, Tally &tally) {
+  int numPlayers = decks.size();
+  const int blockRunouts = runoutsPerBlock(numPlayers);
+  vector<CardSet> blockHands(blockRunouts * numPlayers);
+  vector<int> blockRanks(blockHands.size());
+  vector<CardSet> holes(numPlayers);
+
+  for (int done = 0; done < iterations; done += blockRunouts) {
+    int blockSize = min(blockRunouts, iterations - done);
+
+    for (int b = 0; b < blockSize; b++) {
+      CardSet used;
+      if (!dealCombos(decks, boardSet | deadSet, rng, holes.data(), used))
+        throw invalid_argument("Ranges have no compatible combos");
+
+      // Rest of the board from whatever is left
+      CardSet runout;
+      for (int dealt = 0; dealt < cardsNeeded;) {
+        int idx = rng.below(52);
+        Card c(idx / 4, idx % 4);
+        if (!used.contains(c)) {
+          used.add(c);
+          runout.add(c);
+          dealt++;
+        }
+      }
+
+      for (int p = 0; p < numPlayers; p++)
+        blockHands[b * numPlayers + p] = holes[p] | boardSet | runout;
+    }
+
+    awardHands(blockHands.data(), blockSize, numPlayers, blockRanks,
+               [&](int, int p, double share, int rank) {
+                 tally.record(p, share, Evaluator::category(rank));
+               });
+  }
+}
+
+// Heads-up on the river: every combo pair, weighted, one lookup each
+static EquityResult riverRangeVsRange(const vector<RangeDeck> &decks,
+                                      const vector<Card> &board) {
+  BoardRankTable table(board);
+  const RangeDeck &a = decks[0];
+  const RangeDeck &b = decks[1];
+
+  // Weighted totals, normalised below so it reads as one runout
+  Tally tally(2);
+  double totalWeight = 0.0;
+  long long pairs = 0;
+  for (size_t i = 0; i < a.combos.size(); i++) {
+    int rankA = table.rank(a.comboIds[i]);
+    for (size_t j = 0; j < b.combos.size(); j++) {
+      if (!(a.combos[i] & b.combos[j]).empty())
+        continue;
+      int rankB = table.rank(b.comboIds[j]);
+      double w = a.weights[i] * b.weights[j];
+      double shareA = rankA < rankB ? 1.0 : rankA == rankB ? 0.5 : 0.0;
+      tally.record(0, shareA, Evaluator::category(rankA), w);
+      tally.record(1, 1.0 - shareA, Evaluator::category(rankB), w);
+      totalWeight += w;
+      pairs++;
+    }
+  }
+  if (pairs == 0)
+    throw invalid_argument("Ranges have no compatible combos");
+
+  for (int p = 0; p < 2; p++) {
+    tally.share[p] /= totalWeight;
+    tally.wins[p] /= totalWeight;
+    tally.ties[p] /= totalWeight;
+    for (double &c : tally.categories[p])
+      c /= totalWeight;
+  }
+  EquityResult result = makeResult(tally, 1, true);
+  result.iterations = pairs;
+  return result;
+}
+
+EquityResult EquityCalculator::calculateRanges(const vector<Range> &ranges,
+                                               const vector<Card> &board,
+                                               const EquityOptions &options) {
+  if (ranges.size() < 2)
+    throw invalid_argument("Range equity needs at least two ranges");
+  if (options.shortDeck)
+    throw invalid_argument("Range equity is full-deck Hold'em only");
+  if (board.size() > 5)
+    throw invalid_argument("Board has more than 5 cards");
+
+  CardSet boardSet = CardSet::fromCards(board);
+  CardSet deadSet = CardSet::fromCards(options.deadCards);
+  vector<RangeDeck> decks = buildRangeDecks(ranges, boardSet | deadSet);
+
+  if (board.size() == 5 && ranges.size() == 2)
+    return riverRangeVsRange(decks, board);
+
+  int cardsNeeded = 5 - board.size();
+  return sampleInRounds(ranges.size(), options,
+                        [&](int iterations, FastRng &rng, Tally &tally) {
+                          runRangeSimulations(iterations, decks, boardSet,
+                                              deadSet, cardsNeeded, rng, tally);
+                        });
+}
+
+EquityResult EquityCalculator::calculateVsRanges(
+    const vector<Card> &hand, const vector<Range> &opponents,
+    const vector<Card> &board, const EquityOptions &options) {
+  if (hand.size() != 2)
+    throw invalid_argument("Hand must have 2 cards");
+
+  vector<Range> ranges;
+  ranges.push_back(Range::fromHand(hand[0], hand[1]));
+  ranges.insert(ranges.end(), opponents.begin(), opponents.end());
+
+  // The hero's cards are dead for everyone else
+  CardSet heroCards = CardSet::fromCards(hand);
+  for (size_t p = 1; p < ranges.size(); p++)
+    ranges[p].removeCards(heroCards);
+
+  return calculateRanges(ranges, board, options);
 }
 
 } // namespace poker
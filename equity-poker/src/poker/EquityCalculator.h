@@ -1,19 +1,126 @@
 #pragma once
 
 #include "Card.h"
+#include "Evaluator.h"
+#include "Range.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <vector>
 
 namespace poker {
 
+struct EquityResult;
+
+struct EquityOptions {
+  // Fixed RNG seed for reproducible runs (0 = fresh random seed)
+  uint64_t seed = 0;
+
+  // Sampling budget (preflop); flop, turn and river are always exact
+  long long maxIterations = 100000;
+
+  // Stop sampling once every player's 95% interval is within +/- this
+  // (e.g. 0.005 = half a percent). 0 = always use the full budget
+  double targetPrecision = 0.0;
+
+  // Stop sampling after this many milliseconds (0 = no limit)
+  int timeBudgetMs = 0;
+
+  // Heads-up preflop: answer from the precomputed PreflopTable when the
+  // file is available (exact and O(1)), simulate otherwise
+  bool usePreflopTable = true;
+
+  // Cards known to be out of play (folded hands, burns): never dealt to
+  // the board, nor to a range. Fewer runouts, so flop and turn
+  // enumeration gets cheaper too.
+  std::vector<Card> deadCards;
+
+  // Short-deck (6+) Hold'em: 36-card deck, ShortDeckEvaluator rankings
+  // (known hands only, not with Omaha hands or ranges)
+  bool shortDeck = false;
+
+  // Enumerate every runout even preflop (1.7M boards heads-up)
+  // Meant for offline table generation, far too slow for live use
+  bool forceExact = false;
+
+  // Checked between sampling rounds and enumeration chunks: set it from
+  // another thread to abandon the job (the result is marked cancelled)
+  const std::atomic<bool> *cancel = nullptr;
+
+  // Called on the calling thread after each sampling round with the
+  // estimate so far (rounds grow from 4096 iterations). Exact results
+  // and the final sampled result only come back as the return value.
+  std::function<void(const EquityResult &)> onProgress;
+};
+
+struct EquityResult {
+  std::vector<double> equities;  // pot share per player (0.0 - 1.0)
+  std::vector<double> stdErrors; // standard error per player (0 when exact)
+  std::vector<double> ciLow;     // 95% confidence interval per player
+  std::vector<double> ciHigh;
+  // Scored in the same pass, per player. Empty when the answer comes from
+  // the PreflopTable (it only stores equity).
+  std::vector<double> winRates; // runouts won outright
+  std::vector<double> tieRates; // runouts split (loss = 1 - win - tie)
+  // Final hand made, indexed by HandCategory (sums to 1)
+  std::vector<std::array<double, NUM_HAND_CATEGORIES>> categories;
+  long long iterations = 0; // runouts evaluated (sampled or enumerated)
+  bool exact = false;       // every runout was enumerated
+  bool cancelled = false;   // stopped through EquityOptions::cancel
+};
+
 class EquityCalculator {
 public:
   // Calculate equity for specific known hands
   // Returns a vector of equities (e.g. [0.75, 0.25])
-  // - hands: a vector where each element is a list of 2 hole cards
+  // - hands: a vector where each element is a list of 2 hole cards, or
+  //   4 each for Omaha (exactly 2 hole + 3 board cards, OmahaBoard)
   // - board: 0, 3, 4, or 5 cards
+  // Flop, turn and river are enumerated exactly (every runout), preflop
+  // falls back to Monte Carlo sampling
   static std::vector<double>
   calculateEquity(const std::vector<std::vector<Card>> &hands,
                   const std::vector<Card> &board);
+  static std::vector<double>
+  calculateEquity(const std::vector<std::vector<Card>> &hands,
+                  const std::vector<Card> &board,
+                  const EquityOptions &options);
+
+  // Same as calculateEquity plus iteration count and confidence intervals
+  // Sampling runs in batches and stops early per EquityOptions
+  static EquityResult calculate(const std::vector<std::vector<Card>> &hands,
+                                const std::vector<Card> &board,
+                                const EquityOptions &options = EquityOptions());
+
+  // Exact equity after each possible next board card (every turn on a
+  // flop, every river on a turn), indexed by card (Rank * 4 + Suit)
+  // Dead cards get an empty result. One pass: a flop runout is scored
+  // once and counts for both its turn and river card.
+  // Throws std::invalid_argument unless the board has 3 or 4 cards
+  static std::vector<EquityResult>
+  calculateNextCard(const std::vector<std::vector<Card>> &hands,
+                    const std::vector<Card> &board,
+                    const EquityOptions &options = EquityOptions());
+
+  // Equity of weighted ranges, one per player (e.g. Range::parse("TT+"))
+  // Combos touching the board are skipped; clashing combos between players
+  // are never dealt together. Heads-up on the river is exact over every
+  // combo pair, anything else is sampled (same options as calculate).
+  // Throws std::invalid_argument for fewer than 2 ranges or a range with
+  // nothing left on this board
+  static EquityResult calculateRanges(const std::vector<Range> &ranges,
+                                      const std::vector<Card> &board,
+                                      const EquityOptions &options =
+                                          EquityOptions());
+
+  // Known hand vs one or more ranges (the hand is player 0 in the result,
+  // its cards are removed from the ranges)
+  static EquityResult
+  calculateVsRanges(const std::vector<Card> &hand,
+                    const std::vector<Range> &opponents,
+                    const std::vector<Card> &board,
+                    const EquityOptions &options = EquityOptions());
 };
 
 } // namespace poker
@@ -0,0 +1,224 @@
+#include "EquityHeatmap.h"
+#include "BoardRankTable.h"
+#include "CardSet.h"
+#include "EquityCache.h"
+#include "Evaluator.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace poker {
+
+using namespace std;
+
+// Grid order: Ace first
+static const char GRID_RANKS[] = "AKQJT98765432";
+
+// Runouts per pool task
+static const size_t kRunoutsPerChunk = 64;
+
+string HeatmapCalculator::className(int row, int col) {
+  string name{GRID_RANKS[min(row, col)], GRID_RANKS[max(row, col)]};
+  if (row < col)
+    name += 's';
+  else if (row > col)
+    name += 'o';
+  return name;
+}
+
+// Grid cell of a combo (see EquityHeatmap)
+static void comboCell(const Card &a, const Card &b, int &row, int &col) {
+  int high = 12 - max(a.rank(), b.rank());
+  int low = 12 - min(a.rank(), b.rank());
+  bool suited = a.suit() == b.suit();
+  row = suited ? high : low;
+  col = suited ? low : high;
+}
+
+// Pot share totals per distinct spot, for a chunk of runouts
+struct SpotTally {
+  vector<double> share;
+  vector<long long> runouts;
+
+  explicit SpotTally(size_t spots) : share(spots, 0.0), runouts(spots, 0) {}
+
+  void add(const SpotTally &other) {
+    for (size_t s = 0; s < share.size(); s++) {
+      share[s] += other.share[s];
+      runouts[s] += other.runouts[s];
+    }
+  }
+};
+
+// Scores one runout for the hand and every spot that misses it
+// (scratch buffers reused between calls)
+static void scoreRunout(CardSet runout, CardSet handSet, CardSet boardSet,
+                        const vector<CardSet> &spots, vector<CardSet> &hands,
+                        vector<int> &spotIds, vector<int> &ranks,
+                        SpotTally &tally) {
+  CardSet fullBoard = boardSet | runout;
+  hands.clear();
+  spotIds.clear();
+  hands.push_back(handSet | fullBoard);
+  for (size_t s = 0; s < spots.size(); s++) {
+    if (!(spots[s] & runout).empty())
+      continue;
+    hands.push_back(spots[s] | fullBoard);
+    spotIds.push_back(s);
+  }
+
+  ranks.resize(hands.size());
+  Evaluator::evaluateBatch(hands.data(), hands.size(), ranks.data());
+  for (size_t i = 0; i < spotIds.size(); i++) {
+    int theirs = ranks[i + 1];
+    tally.share[spotIds[i]] +=
+        ranks[0] < theirs ? 1.0 : ranks[0] == theirs ? 0.5 : 0.0;
+    tally.runouts[spotIds[i]]++;
+  }
+}
+
+EquityHeatmap HeatmapCalculator::calculate(const vector<Card> &hand,
+                                           const vector<Card> &board,
+                                           const EquityOptions &options) {
+  CardSet handSet = CardSet::fromCards(hand);
+  CardSet boardSet = CardSet::fromCards(board);
+  if (hand.size() != 2 || handSet.size() != 2)
+    throw invalid_argument("Hand must have 2 different cards");
+  if (board.size() > 5 || board.size() == 1 || board.size() == 2 ||
+      boardSet.size() != static_cast<int>(board.size()) ||
+      !(handSet & boardSet).empty())
+    throw invalid_argument("Board must be 0, 3, 4 or 5 cards off the hand");
+
+  CardSet blocked =
+      handSet | boardSet | CardSet::fromCards(options.deadCards);
+
+  // 1. Opposing combos, one spot per suit-isomorphism class
+  // The hand's position in the canonical order is part of the key:
+  // swapped hands are the mirrored spot, not the same one
+  vector<int> comboSpot(BoardRankTable::NUM_COMBOS, -1);
+  vector<CardSet> spots;
+  unordered_map<string, int> spotIds;
+  for (int combo = 0; combo < BoardRankTable::NUM_COMBOS; combo++) {
+    Card a, b;
+    BoardRankTable::comboCards(combo, a, b);
+    CardSet set;
+    set.add(a);
+    set.add(b);
+    if (!(set & blocked).empty())
+      continue;
+
+    vector<int> order;
+    string key = EquityCache::canonicalKey({hand, {a, b}}, board, order,
+                                           options.deadCards);
+    key += static_cast<char>(order[0]);
+    auto it = spotIds.find(key);
+    if (it == spotIds.end()) {
+      it = spotIds.emplace(key, spots.size()).first;
+      spots.push_back(set);
+    }
+    comboSpot[combo] = it->second;
+  }
+
+  // 2. Score runouts, shared by every spot
+  vector<Card> deck;
+  for (int idx = 0; idx < 52; idx++) {
+    Card c = BoardRankTable::cardFromIndex(idx);
+    if (!blocked.contains(c))
+      deck.push_back(c);
+  }
+
+  const int cardsNeeded = 5 - board.size();
+  const bool exact = cardsNeeded <= 2;
+  vector<CardSet> runouts;
+  size_t total;
+  if (exact) {
+    // River: one empty runout, turn: every river, flop: every pair
+    if (cardsNeeded == 0)
+      runouts.push_back(CardSet());
+    for (size_t i = 0; i < deck.size() && cardsNeeded > 0; i++) {
+      if (cardsNeeded == 1) {
+        runouts.push_back(CardSet(CardSet::bit(deck[i])));
+        continue;
+      }
+      for (size_t j = i + 1; j < deck.size(); j++)
+        runouts.push_back(CardSet(CardSet::bit(deck[i]) |
+                                  CardSet::bit(deck[j])));
+    }
+    total = runouts.size();
+  } else {
+    total = max<long long>(1, options.maxIterations / 20);
+  }
+
+  uint64_t seed = options.seed;
+  if (seed == 0)
+    seed = (static_cast<uint64_t>(random_device{}()) << 32) ^ random_device{}();
+
+  size_t numChunks = (total + kRunoutsPerChunk - 1) / kRunoutsPerChunk;
+  vector<SpotTally> chunkTallies(numChunks, SpotTally(spots.size()));
+  vector<FastRng> rngs; // chunk k draws from stream k (sampling only)
+  if (!exact) {
+    FastRng streams(seed);
+    rngs.reserve(numChunks);
+    for (size_t c = 0; c < numChunks; c++)
+      rngs.push_back(streams.nextStream());
+  }
+  auto cancelled = [&] {
+    return options.cancel && options.cancel->load(memory_order_relaxed);
+  };
+
+  ThreadPool::instance().parallelFor(
+      total, kRunoutsPerChunk, [&](size_t begin, size_t end) {
+        if (cancelled())
+          return;
+        size_t chunk = begin / kRunoutsPerChunk;
+        vector<CardSet> hands;
+        vector<int> ids, ranks;
+        vector<Card> localDeck = deck;
+        for (size_t i = begin; i < end; i++) {
+          CardSet runout =
+              exact ? runouts[i]
+                    : drawCards(localDeck.data(), localDeck.size(),
+                                cardsNeeded, rngs[chunk]);
+          scoreRunout(runout, handSet, boardSet, spots, hands, ids, ranks,
+                      chunkTallies[chunk]);
+        }
+      });
+
+  SpotTally spotTotals(spots.size());
+  for (const auto &t : chunkTallies)
+    spotTotals.add(t);
+
+  // 3. Classes: average over their combos still in play
+  EquityHeatmap heatmap;
+  array<array<double, 13>, 13> sum{};
+  for (auto &row : heatmap.combos)
+    row.fill(0);
+  for (int combo = 0; combo < BoardRankTable::NUM_COMBOS; combo++) {
+    int spot = comboSpot[combo];
+    if (spot < 0 || spotTotals.runouts[spot] == 0)
+      continue;
+    Card a, b;
+    BoardRankTable::comboCards(combo, a, b);
+    int row, col;
+    comboCell(a, b, row, col);
+    sum[row][col] +=
+        spotTotals.share[spot] / static_cast<double>(spotTotals.runouts[spot]);
+    heatmap.combos[row][col]++;
+  }
+  for (int row = 0; row < 13; row++) {
+    for (int col = 0; col < 13; col++) {
+      int n = heatmap.combos[row][col];
+      heatmap.equity[row][col] = n > 0 ? sum[row][col] / n : -1.0;
+    }
+  }
+
+  heatmap.iterations = total;
+  heatmap.exact = exact;
+  heatmap.cancelled = cancelled();
+  return heatmap;
+}
+
+} // namespace poker
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Card.h"
+#include "EquityCalculator.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace poker {
+
+// A hand's equity against each of the 169 starting-hand classes
+// Grid layout as on a range chart (0 = Ace ... 12 = Two):
+//   row == col  pairs (AA top left)
+//   row <  col  suited (AKs at [0][1])
+//   row >  col  offsuit (AKo at [1][0])
+struct EquityHeatmap {
+  // Hand's equity vs a random combo of the class (-1 if no combo of the
+  // class is left after card removal)
+  std::array<std::array<double, 13>, 13> equity;
+  // Combos of the class still possible
+  std::array<std::array<int, 13>, 13> combos;
+  long long iterations = 0; // runouts scored (each for every class)
+  bool exact = false;
+  bool cancelled = false;
+};
+
+class HeatmapCalculator {
+public:
+  // One pass for all 169 classes: every runout is scored for the hand once
+  // and for every opposing combo, and combos that are the same spot up to
+  // suit renaming (e.g. AhAd and AhAc vs AsKs) are only scored once.
+  // Flop, turn and river are exact; preflop samples maxIterations / 20
+  // boards (options.seed / cancel / deadCards apply, the rest is ignored).
+  // Throws std::invalid_argument for a bad hand or board
+  static EquityHeatmap calculate(const std::vector<Card> &hand,
+                                 const std::vector<Card> &board,
+                                 const EquityOptions &options = EquityOptions());
+
+  // "AA", "AKs", "AKo" for a grid cell
+  static std::string className(int row, int col);
+};
+
+} // namespace poker
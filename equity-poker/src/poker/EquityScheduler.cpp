@@ -0,0 +1,167 @@
+#include "EquityScheduler.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace poker {
+
+using namespace std;
+
+// Never sample less than this share of the normal budget
+static const double kMinBudget = 0.1;
+
+void EquityBudget::apply(EquityOptions &options) const {
+  if (scale < 1.0) {
+    options.maxIterations =
+        max(4096LL, static_cast<long long>(options.maxIterations * scale));
+    options.targetPrecision /= sqrt(scale);
+  }
+  if (cancel)
+    options.cancel = cancel;
+}
+
+double achievedPrecision(const EquityResult &result) {
+  double widest = 0.0;
+  for (size_t p = 0; p < result.ciLow.size(); p++)
+    widest = max(widest, (result.ciHigh[p] - result.ciLow[p]) / 2);
+  return widest;
+}
+
+EquityScheduler::EquityScheduler(int maxRunning)
+    : maxRunning(max(1, maxRunning)) {}
+
+EquityScheduler::~EquityScheduler() { wait(); }
+
+EquityScheduler &EquityScheduler::instance() {
+  // Never destroyed: jobs may still be running at process exit
+  static EquityScheduler *scheduler =
+      new EquityScheduler(ThreadPool::instance().size());
+  return *scheduler;
+}
+
+void EquityScheduler::submit(const string &room, Clock::time_point deadline,
+                             Job job) {
+  lock_guard<mutex> lock(mtx);
+  Room &r = rooms[room];
+  if (r.waiting) {
+    stats.coalesced++; // keeps its turn
+  } else {
+    r.waiting = true;
+    ready.push_back(room);
+  }
+  if (r.running)
+    *r.running = true;
+  r.job = std::move(job);
+  r.deadline = deadline;
+  dispatch();
+}
+
+void EquityScheduler::cancel(const string &room) {
+  lock_guard<mutex> lock(mtx);
+  auto it = rooms.find(room);
+  if (it == rooms.end())
+    return;
+  if (it->second.waiting)
+    ready.erase(find(ready.begin(), ready.end(), room));
+  if (it->second.running) {
+    *it->second.running = true;
+    it->second.waiting = false;
+    it->second.job = nullptr;
+  } else {
+    rooms.erase(it);
+  }
+  idle.notify_all();
+}
+
+void EquityScheduler::wait() {
+  unique_lock<mutex> lock(mtx);
+  idle.wait(lock, [this] { return ready.empty() && stats.running == 0; });
+}
+
+EquityScheduler::Metrics EquityScheduler::metrics() const {
+  lock_guard<mutex> lock(mtx);
+  Metrics m = stats;
+  m.queueDepth = ready.size();
+  return m;
+}
+
+// Called with the lock held: starts waiting jobs in turn while there are
+// free slots (rooms whose last job is still running wait their turn)
+void EquityScheduler::dispatch() {
+  auto now = Clock::now();
+  for (auto it = ready.begin();
+       it != ready.end() && stats.running < maxRunning;) {
+    Room &r = rooms[*it];
+    if (r.running) {
+      ++it;
+      continue;
+    }
+    string room = *it;
+    it = ready.erase(it);
+    r.waiting = false;
+    Job job = std::move(r.job);
+    r.job = nullptr;
+    if (now > r.deadline) {
+      stats.shed++;
+      rooms.erase(room);
+      continue;
+    }
+
+    // Share the slots between everyone waiting (and this job)
+    double waiting = static_cast<double>(ready.size() + stats.running + 1);
+    EquityBudget budget;
+    budget.scale = clamp(maxRunning / waiting, kMinBudget, 1.0);
+    if (budget.scale < 1.0)
+      stats.degraded++;
+    stats.lastBudget = budget.scale;
+
+    auto cancel = make_shared<atomic<bool>>(false);
+    budget.cancel = cancel.get();
+    r.running = cancel;
+    stats.running++;
+    ThreadPool::instance().submit(
+        [this, room, cancel, budget, job = std::move(job)] {
+          double precision = -1.0;
+          bool failed = false;
+          try {
+            precision = job(budget);
+          } catch (const exception &e) {
+            cerr << "Equity job failed (" << room << "): " << e.what()
+                 << endl;
+            failed = true;
+          }
+          if (*cancel || failed)
+            precision = -1.0;
+          finish(room, cancel, precision, failed);
+        });
+  }
+  if (ready.empty() && stats.running == 0)
+    idle.notify_all();
+}
+
+void EquityScheduler::finish(const string &room,
+                             const shared_ptr<atomic<bool>> &cancel,
+                             double precision, bool failed) {
+  lock_guard<mutex> lock(mtx);
+  stats.running--;
+  stats.completed++;
+  if (failed)
+    stats.failed++;
+  if (precision >= 0.0) {
+    stats.lastPrecision = precision;
+    precisionSum += precision;
+    precisionCount++;
+    stats.meanPrecision = precisionSum / precisionCount;
+  }
+
+  auto it = rooms.find(room);
+  if (it != rooms.end() && it->second.running == cancel) {
+    it->second.running.reset();
+    if (!it->second.waiting)
+      rooms.erase(it);
+  }
+  dispatch();
+}
+
+} // namespace poker
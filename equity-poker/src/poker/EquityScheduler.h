@@ -0,0 +1,100 @@
+#pragma once
+
+#include "EquityCalculator.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace poker {
+
+// What a job may spend, decided when it starts
+struct EquityBudget {
+  // Fraction of the normal sampling budget (below 1 under overload)
+  double scale = 1.0;
+  // Set when the job is cancelled or superseded by a newer one
+  const std::atomic<bool> *cancel = nullptr;
+
+  // Scales maxIterations, loosens targetPrecision to match (error grows
+  // with 1 / sqrt(iterations)) and hooks up cancel
+  void apply(EquityOptions &options) const;
+};
+
+// Widest 95% half-interval of a result (0 when exact)
+double achievedPrecision(const EquityResult &result);
+
+// Runs equity jobs from many rooms on the ThreadPool
+// - one queue slot per room: a newer job for the room replaces the one
+//   still waiting and cancels the one running (both are out of date)
+// - rooms take turns (round robin), at most one running job per room
+// - a job still waiting at its deadline is dropped
+// - with more rooms waiting than job slots, jobs get a smaller budget
+class EquityScheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+  // Runs on the pool, returns achievedPrecision of what it computed
+  // (negative if unknown or cancelled)
+  using Job = std::function<double(const EquityBudget &)>;
+
+  struct Metrics {
+    size_t queueDepth = 0;  // rooms with a job waiting
+    int running = 0;
+    long long completed = 0;
+    long long coalesced = 0; // waiting jobs replaced by a newer one
+    long long shed = 0;      // jobs dropped at their deadline
+    long long degraded = 0;  // jobs started on a reduced budget
+    long long failed = 0;    // jobs that threw (counted as completed)
+    double lastBudget = 1.0; // scale of the last job started
+    double lastPrecision = -1.0;
+    double meanPrecision = -1.0; // over every job that reported one
+  };
+
+  // maxRunning: jobs on the pool at once (each one also splits its own
+  // work over the pool)
+  explicit EquityScheduler(int maxRunning);
+  ~EquityScheduler();
+
+  EquityScheduler(const EquityScheduler &) = delete;
+  EquityScheduler &operator=(const EquityScheduler &) = delete;
+
+  // Process-wide scheduler, one job slot per pool thread
+  static EquityScheduler &instance();
+
+  void submit(const std::string &room, Clock::time_point deadline, Job job);
+  // Drops the room's waiting job and cancels its running one
+  void cancel(const std::string &room);
+  // Blocks until nothing is waiting or running
+  void wait();
+
+  Metrics metrics() const;
+
+private:
+  struct Room {
+    bool waiting = false;
+    Job job;
+    Clock::time_point deadline;
+    std::shared_ptr<std::atomic<bool>> running; // cancel flag, if running
+  };
+
+  void dispatch();
+  void finish(const std::string &room,
+              const std::shared_ptr<std::atomic<bool>> &cancel,
+              double precision, bool failed);
+
+  int maxRunning;
+  mutable std::mutex mtx;
+  std::condition_variable idle;
+  std::unordered_map<std::string, Room> rooms;
+  std::deque<std::string> ready; // rooms with a waiting job, in turn order
+  Metrics stats;
+  double precisionSum = 0.0;
+  long long precisionCount = 0;
+};
+
+} // namespace poker
@@ -1,54 +1,35 @@
 #include "Evaluator.h"
+#include "EvaluatorBatch.h"
 #include "EvaluatorConstants.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 namespace poker {
 
-// Perfect Hash Function
-static unsigned find_fast(unsigned u) {
-  unsigned a, b, r;
-  u += 0xe91aaa35;
-  u ^= u >> 16;
-  u += u << 8;
-  u ^= u >> 4;
-  b = (u >> 8) & 0x1ff;
-  a = (u + (u << 2)) >> 19;
-  r = a ^ hash_adjust[b];
-  return r;
-}
-
-// Change our card to the Cactus Kev format
-// p = prime number
-// r = rank
-// s = suit bit
-// b = rank bit
-static int convert_card(const Card &c) {
-  // 1. Prime (0-7)
-  int p = PRIMES[c.rank()];
-
-  // 2. Rank (8-11)
-  int r = (c.rank() << 8);
+// The lookup tables (flush masks and rank multisets) are generated at
+// compile time, see EvaluatorConstants.h; the AVX2 batch path lives in
+// EvaluatorBatch.h
 
-  // 3. Suit (12-15)
-  int s = (1 << (12 + c.suit()));
-
-  // 4. Rank Bit (16-31)
-  int b = (1 << (16 + c.rank()));
+int Evaluator::evaluate(const std::vector<Card> &cards) {
+  return evaluate(cards.data(), cards.size());
+}
 
-  return b | s | r | p;
+int Evaluator::evaluate(const std::array<Card, 7> &cards) {
+  return evaluateDirect(cards.data(), 7);
 }
 
-int Evaluator::evaluate(const std::vector<Card> &cards) {
-  // If 5 cards -> evaluate5
-  if (cards.size() == 5) {
-    return evaluate5(cards[0], cards[1], cards[2], cards[3], cards[4]);
+int Evaluator::evaluate(const Card *cards, int n) {
+  // If 5, 6 or 7 cards -> direct lookup
+  if (n >= 5 && n <= 7) {
+    return evaluateDirect(cards, n);
   }
 
   int bestScore = 9999;
-  int n = cards.size();
 
-  // If 6 or 7 cards -> Loop 21 combinations
+  // Anything else -> Loop over every 5 card combination
   for (int i = 0; i < n - 4; i++) {
     for (int j = i + 1; j < n - 3; j++) {
       for (int k = j + 1; k < n - 2; k++) {
@@ -66,32 +47,168 @@ int Evaluator::evaluate(const std::vector<Card> &cards) {
   return bestScore;
 }
 
-int Evaluator::evaluate5(const Card &c1_obj, const Card &c2_obj,
-                         const Card &c3_obj, const Card &c4_obj,
-                         const Card &c5_obj) {
-  // Convert to Cactus Kev Format
-  int c1 = convert_card(c1_obj);
-  int c2 = convert_card(c2_obj);
-  int c3 = convert_card(c3_obj);
-  int c4 = convert_card(c4_obj);
-  int c5 = convert_card(c5_obj);
+int Evaluator::evaluate(CardSet cards) {
+  int n = cards.size();
+  if (n < 5 || n > 7) {
+    // Rare sizes go through the generic path
+    Card buffer[52];
+    int count = 0;
+    for (Card c : cards)
+      buffer[count++] = c;
+    return evaluate(buffer, count);
+  }
+
+  unsigned char counts[13] = {0};
+  int suitCount[4] = {0, 0, 0, 0};
+  for (Card c : cards) {
+    counts[c.rank()]++;
+    suitCount[c.suit()]++;
+  }
+
+  // Check Flush (one suit lane with 5+ cards)
+  for (int s = 0; s < 4; s++) {
+    if (suitCount[s] >= 5)
+      return evaluatorTables.flushBest[cards.suitMask(s)];
+  }
+
+  // Check Rank
+  return evaluatorTables.ranksOnly(counts, n);
+}
+
+void Evaluator::evaluateBatch(const CardSet *hands, int n, int *out) {
+  batch::evaluate(evaluatorTables, 0, hands, n, out,
+                  [](CardSet hand) { return evaluate(hand); });
+}
+
+int Evaluator::evaluateRanks(const unsigned char *counts, int n) {
+  return evaluatorTables.ranksOnly(counts, n);
+}
+
+int Evaluator::evaluateFlush(unsigned suitMask) {
+  return evaluatorTables.flushBest[suitMask & 0x1FFF];
+}
+
+int Evaluator::evaluateOmaha(const std::vector<Card> &hole,
+                             const std::vector<Card> &board) {
+  CardSet holeSet = CardSet::fromCards(hole);
+  CardSet boardSet = CardSet::fromCards(board);
+  if (hole.size() != 4 || holeSet.size() != 4)
+    throw std::invalid_argument("Omaha needs 4 different hole cards");
+  if (board.size() < 3 || board.size() > 5 ||
+      boardSet.size() != static_cast<int>(board.size()) ||
+      !(holeSet & boardSet).empty())
+    throw std::invalid_argument("Omaha board must be 3-5 cards off the hand");
+  return OmahaBoard(boardSet).evaluate(holeSet);
+}
+
+OmahaBoard::OmahaBoard(CardSet board) {
+  Card cards[5];
+  int n = 0;
+  for (Card c : board)
+    cards[n++] = c;
+
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      for (int k = j + 1; k < n; k++) {
+        Subset &s = subsets[numSubsets++];
+        std::fill(s.counts, s.counts + 13, 0);
+        s.suit = -1;
+        s.mask = 0;
+        for (const Card &c : {cards[i], cards[j], cards[k]})
+          s.counts[c.rank()]++;
+        if (cards[i].suit() == cards[j].suit() &&
+            cards[j].suit() == cards[k].suit()) {
+          s.suit = cards[i].suit();
+          s.mask = (1u << cards[i].rank()) | (1u << cards[j].rank()) |
+                   (1u << cards[k].rank());
+        }
+      }
+    }
+  }
+}
 
-  int q = (c1 | c2 | c3 | c4 | c5) >> 16;
-  short s;
+int OmahaBoard::evaluate(CardSet hole) const {
+  Card cards[4];
+  int n = 0;
+  for (Card c : hole)
+    cards[n++] = c;
+
+  int best = 9999;
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      const Card &a = cards[i];
+      const Card &b = cards[j];
+      int pairSuit = a.suit() == b.suit() ? a.suit() : -1;
+      unsigned pairMask = (1u << a.rank()) | (1u << b.rank());
+
+      for (int s = 0; s < numSubsets; s++) {
+        const Subset &sub = subsets[s];
+        // Five cards of one suit can't pair, so the flush is the hand
+        int rank;
+        if (pairSuit >= 0 && pairSuit == sub.suit) {
+          rank = Evaluator::evaluateFlush(sub.mask | pairMask);
+        } else {
+          unsigned char counts[13];
+          std::copy(sub.counts, sub.counts + 13, counts);
+          counts[a.rank()]++;
+          counts[b.rank()]++;
+          rank = Evaluator::evaluateRanks(counts, 5);
+        }
+        best = std::min(best, rank);
+      }
+    }
+  }
+  return best;
+}
+
+// Worst rank of each category, best category first
+static const int CATEGORY_LAST_RANK[NUM_HAND_CATEGORIES] = {
+    10, 166, 322, 1599, 1609, 2467, 3325, 6185, 7462};
+
+HandCategory Evaluator::category(int rank) {
+  int c = 0;
+  while (c < NUM_HAND_CATEGORIES - 1 && rank > CATEGORY_LAST_RANK[c])
+    c++;
+  return static_cast<HandCategory>(c);
+}
+
+const char *Evaluator::categoryName(HandCategory category) {
+  static const char *const NAMES[NUM_HAND_CATEGORIES] = {
+      "Straight Flush", "Four of a Kind", "Full House",
+      "Flush",          "Straight",       "Three of a Kind",
+      "Two Pair",       "One Pair",       "High Card"};
+  return NAMES[static_cast<int>(category)];
+}
+
+int Evaluator::evaluate5(const Card &c1, const Card &c2, const Card &c3,
+                         const Card &c4, const Card &c5) {
+  const Card cards[5] = {c1, c2, c3, c4, c5};
+  return evaluateDirect(cards, 5);
+}
+
+int Evaluator::evaluateDirect(const Card *cards, int n) {
+  unsigned suitMask[4] = {0, 0, 0, 0};
+  int suitCount[4] = {0, 0, 0, 0};
+  unsigned char counts[13] = {0};
+
+  for (int i = 0; i < n; i++) {
+    int r = cards[i].rank();
+    int s = cards[i].suit();
+    suitMask[s] |= 1u << r;
+    suitCount[s]++;
+    counts[r]++;
+  }
 
   // Check Flush
-  // (c1 & ... & 0xF000) checks if ALL cards share a suit bit
-  if (c1 & c2 & c3 & c4 & c5 & 0xF000)
-    return flushes[q];
-
-  // Check Rank (Unique5 Lookup)
-  if ((s = unique5[q]))
-    return s;
-
-  // Check Rank (Perfect Hash Lookup for non-unique-rank hands like Pairs)
-  // We multiply only the lower 8 bits (the Primes)
-  return hash_values[find_fast((c1 & 0xff) * (c2 & 0xff) * (c3 & 0xff) *
-                               (c4 & 0xff) * (c5 & 0xff))];
+  // With 7 cards or less a flush rules out quads and full houses,
+  // so the best flush in that suit is the answer
+  for (int s = 0; s < 4; s++) {
+    if (suitCount[s] >= 5)
+      return evaluatorTables.flushBest[suitMask[s]];
+  }
+
+  // Check Rank (one lookup for the rank multiset)
+  return evaluatorTables.ranksOnly(counts, n);
 }
 
 } // namespace poker
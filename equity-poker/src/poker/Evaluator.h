@@ -1,21 +1,91 @@
 #pragma once
 
 #include "Card.h"
+#include "CardSet.h"
+#include <array>
 #include <vector>
 
 namespace poker {
 
-// Hand Evaluator using Perfect Hash Function
-// Super fast O(1) lookup
+// The nine hand categories, best first
+enum class HandCategory {
+  StraightFlush,
+  FourOfAKind,
+  FullHouse,
+  Flush,
+  Straight,
+  ThreeOfAKind,
+  TwoPair,
+  OnePair,
+  HighCard
+};
+static const int NUM_HAND_CATEGORIES = 9;
+
+// Hand Evaluator using direct table lookups
+// Super fast O(1) lookup (tables built by the compiler, see
+// EvaluatorConstants.h)
 class Evaluator {
 public:
   // Evaluates 5, 6, or 7 cards and returns a rank (1 = Royal Flush)
   static int evaluate(const std::vector<Card> &cards);
 
+  // Allocation-free overloads (same ranks as above)
+  static int evaluate(const Card *cards, int n);
+  static int evaluate(const std::array<Card, 7> &cards);
+  static int evaluate(CardSet cards);
+
+  // Scores n hands at once (AVX2 when the CPU has it, scalar otherwise)
+  // out[i] = evaluate(hands[i])
+  static void evaluateBatch(const CardSet *hands, int n, int *out);
+
+  // Building blocks for table builders (e.g. BoardRankTable)
+  // Best rank from rank counts alone (5-7 cards, suits ignored)
+  static int evaluateRanks(const unsigned char *counts, int n);
+  // Best flush / straight flush in a 13-bit suit mask (0 if < 5 cards)
+  static int evaluateFlush(unsigned suitMask);
+
+  // Omaha: best hand from exactly 2 of the 4 hole cards and 3 of the
+  // 3-5 board cards (up to 60 combinations, see OmahaBoard)
+  // Throws std::invalid_argument for other card counts or duplicates
+  static int evaluateOmaha(const std::vector<Card> &hole,
+                           const std::vector<Card> &board);
+
+  // Ranks come grouped by category (1-10 straight flushes, 11-166 quads,
+  // ...), so the category is a range check
+  static HandCategory category(int rank);
+  static const char *categoryName(HandCategory category);
+
 private:
   // Helper for just 5 cards
   static int evaluate5(const Card &c1, const Card &c2, const Card &c3,
                        const Card &c4, const Card &c5);
+
+  // Helper for 5, 6 or 7 cards
+  // One flush check from per-suit rank masks, then one lookup
+  // in the rank-multiset table (no 21-combination loop)
+  static int evaluateDirect(const Card *cards, int n);
+};
+
+// Board side of Omaha evaluation, built once per board and shared by
+// every hand on it: the 3-card board subsets (1 on the flop, 4 on the
+// turn, 10 on the river) with their rank counts and flush suit
+class OmahaBoard {
+public:
+  // board: 3-5 cards
+  explicit OmahaBoard(CardSet board);
+
+  // Best of the 6 hole pairs x board subsets (hole: 4 cards off the board)
+  int evaluate(CardSet hole) const;
+
+private:
+  struct Subset {
+    unsigned char counts[13];
+    int suit;      // the subset's suit if all 3 match, -1 otherwise
+    unsigned mask; // its rank mask in that suit
+  };
+
+  Subset subsets[10];
+  int numSubsets = 0;
 };
 
 } // namespace poker
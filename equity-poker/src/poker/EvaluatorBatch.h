@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CardSet.h"
+#include "EvaluatorConstants.h"
+
+// AVX2 batch path (x86 only, picked at runtime)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POKER_AVX2_BATCH 1
+#include <immintrin.h>
+#endif
+
+namespace poker {
+
+// Batch evaluation over a RankTables, shared by Evaluator (13 ranks) and
+// ShortDeckEvaluator (9 ranks, lowest = the 6). Internal to the two.
+namespace batch {
+
+#ifdef POKER_AVX2_BATCH
+inline bool cpuHasAvx2() {
+  static const bool has = __builtin_cpu_supports("avx2");
+  return has;
+}
+
+// Same lookups as the scalar CardSet paths, 8 hands per pass.
+// Tables hold shorts, so we gather 32 bits and keep the low half.
+// Returns a bitmask of lanes that were not 5-7 cards (caller redoes them).
+template <int Ranks>
+__attribute__((target("avx2"))) int
+evaluate8Avx2(const RankTables<Ranks> &t, int lowestRank,
+              const CardSet *hands, int *out) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i lowHalf = _mm256_set1_epi32(0xFFFF);
+
+  // Split each hand into its 4 suit masks (bit 0 = the lowest rank)
+  alignas(32) int lanes[4][8];
+  for (int i = 0; i < 8; i++) {
+    for (int s = 0; s < 4; s++)
+      lanes[s][i] = static_cast<int>(hands[i].suitMask(s) >> lowestRank);
+  }
+  __m256i suit[4];
+  for (int s = 0; s < 4; s++)
+    suit[s] = _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes[s]));
+
+  // 1. Flush: flushBest is 0 below 5 bits and only one suit can hit
+  const int *flushTable = reinterpret_cast<const int *>(t.flushBest);
+  __m256i flush = _mm256_setzero_si256();
+  for (int s = 0; s < 4; s++) {
+    flush = _mm256_or_si256(
+        flush, _mm256_and_si256(
+                   _mm256_i32gather_epi32(flushTable, suit[s], 2), lowHalf));
+  }
+
+  // 2. Rank counts (+ total cards per lane)
+  __m256i counts[Ranks];
+  __m256i total = _mm256_setzero_si256();
+  for (int r = 0; r < Ranks; r++) {
+    __m256i c = _mm256_setzero_si256();
+    for (int s = 0; s < 4; s++)
+      c = _mm256_add_epi32(
+          c, _mm256_and_si256(_mm256_srli_epi32(suit[s], r), one));
+    counts[r] = c;
+    total = _mm256_add_epi32(total, c);
+  }
+
+  // 3. Multiset index: offsets[r][left][count]
+  const int *offsets = &t.offsets[0][0][0];
+  __m256i idx = _mm256_setzero_si256();
+  __m256i left = total;
+  for (int r = 0; r < Ranks; r++) {
+    __m256i slot = _mm256_add_epi32(
+        _mm256_set1_epi32(r * 40),
+        _mm256_add_epi32(_mm256_mullo_epi32(left, _mm256_set1_epi32(5)),
+                         counts[r]));
+    idx = _mm256_add_epi32(idx, _mm256_i32gather_epi32(offsets, slot, 4));
+    left = _mm256_sub_epi32(left, counts[r]);
+  }
+
+  // 4. Pick the 5/6/7 card table per lane and look up the rank
+  const __m256i starts = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i *>(t.noFlushStart));
+  idx = _mm256_add_epi32(idx, _mm256_permutevar8x32_epi32(starts, total));
+  const int *noFlushTable = reinterpret_cast<const int *>(t.noFlush);
+  __m256i rank = _mm256_and_si256(
+      _mm256_i32gather_epi32(noFlushTable, idx, 2), lowHalf);
+
+  // Flush wins when present
+  __m256i hasFlush = _mm256_cmpgt_epi32(flush, _mm256_setzero_si256());
+  rank = _mm256_blendv_epi8(rank, flush, hasFlush);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), rank);
+
+  // Lanes outside 5..7 cards
+  __m256i tooFew = _mm256_cmpgt_epi32(_mm256_set1_epi32(5), total);
+  __m256i tooMany = _mm256_cmpgt_epi32(total, _mm256_set1_epi32(7));
+  return _mm256_movemask_ps(
+      _mm256_castsi256_ps(_mm256_or_si256(tooFew, tooMany)));
+}
+#endif
+
+// out[i] = scalar(hands[i]), 8 at a time with AVX2 when the CPU has it
+template <int Ranks, typename Scalar>
+void evaluate(const RankTables<Ranks> &t, int lowestRank, const CardSet *hands,
+              int n, int *out, Scalar scalar) {
+  int i = 0;
+
+#ifdef POKER_AVX2_BATCH
+  if (cpuHasAvx2()) {
+    for (; i + 8 <= n; i += 8) {
+      int redo = evaluate8Avx2(t, lowestRank, hands + i, out + i);
+      for (int lane = 0; redo != 0; lane++, redo >>= 1) {
+        if (redo & 1)
+          out[i + lane] = scalar(hands[i + lane]);
+      }
+    }
+  }
+#endif
+
+  // Scalar fallback (and the leftover hands)
+  for (; i < n; i++)
+    out[i] = scalar(hands[i]);
+}
+
+} // namespace batch
+
+} // namespace poker
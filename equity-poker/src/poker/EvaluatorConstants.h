@@ -1,16 +1,273 @@
 #pragma once
 
-#include <vector>
+#include <initializer_list>
 
 namespace poker {
 
-// Prime numbers for Ranks 2..A
-static const int PRIMES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41};
+// Lookup tables for the direct evaluators, generated by the compiler.
+// One template serves the 52-card deck (13 ranks, Evaluator) and the
+// short deck (9 ranks, ShortDeckEvaluator); only the order of the
+// categories differs, see RankLayout.
+//
+// Rank bits / indices: 0 = lowest rank in the deck, ranks - 1 = the Ace.
+// Hand ranks: 1 = royal flush, lower is better.
 
-// Lookup tables for the Perfect Hash optimisation
-extern short flushes[];              // check for flush rank
-extern short unique5[];              // check for straight/high card
-extern unsigned short hash_adjust[]; // help with hash function
-extern unsigned short hash_values[]; // map product to rank
+// First rank of each category and the number of ranks in the deck
+struct RankLayout {
+  int ranks;
+  int straightFlush;
+  int quads;
+  int fullHouse;
+  int flush;
+  int straight;
+  int trips;
+  int twoPair;
+  int pair;
+  int highCard;
+};
+
+// Cactus Kev order: 10 straight flushes, 156 quads, 156 full houses,
+// 1277 flushes, 10 straights, 858 trips, 858 two pair, 2860 pairs and
+// 1277 high cards (7462 in all)
+constexpr RankLayout kStandardLayout = {13,  1,    11,   167,  323,
+                                        1600, 1610, 2468, 3326, 6186};
+
+// 6+ Hold'em: a flush beats a full house (1404 hands)
+constexpr RankLayout kShortDeckLayout = {9,   1,   7,   199, 79,
+                                         271, 277, 529, 781, 1285};
+
+namespace tablegen {
+
+// Kept cheap to evaluate: the 52-card tables take ~74k countsRank calls,
+// which is still over the compilers' default constexpr budget (raised for
+// EvaluatorConstants.cpp in CMakeLists.txt)
+
+constexpr int bitCount(unsigned x) {
+  x = x - ((x >> 1) & 0x55555555u);
+  x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+  return static_cast<int>((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+constexpr int choose(int n, int k) {
+  if (k < 0 || k > n)
+    return 0;
+  int result = 1;
+  for (int i = 0; i < k; i++)
+    result = result * (n - i) / (i + 1);
+  return result;
+}
+
+// Rank multisets of n cards with up to 4 of each rank
+constexpr int multisets(int ranks, int n) {
+  int ways[8] = {1}; // ways[k]: multisets of k cards over the ranks so far
+  for (int r = 0; r < ranks; r++) {
+    for (int k = 7; k > 0; k--) {
+      for (int c = 1; c <= 4 && c <= k; c++)
+        ways[k] += ways[k - c];
+    }
+  }
+  return ways[n];
+}
+
+// Index of a single rank bit
+constexpr int bitIndex(unsigned bit) { return bitCount(bit - 1); }
+
+constexpr unsigned highestBit(unsigned mask) {
+  while (mask & (mask - 1))
+    mask &= mask - 1;
+  return mask;
+}
+
+// The k best ranks of a mask
+constexpr unsigned topRanks(unsigned mask, int k) {
+  for (int n = bitCount(mask); n > k; n--)
+    mask &= mask - 1;
+  return mask;
+}
+
+// Among the k-rank subsets of allowed, how many beat mask (higher ranks
+// first: a bigger mask is a better set of the same size). Colex rank,
+// counted from the top.
+constexpr int subsetsAbove(unsigned mask, unsigned allowed, int k) {
+  int below = 0;
+  int i = 1;
+  for (; mask; mask &= mask - 1, i++)
+    below += choose(bitCount(allowed & ((mask & (0u - mask)) - 1)), i);
+  return choose(bitCount(allowed), k) - 1 - below;
+}
+
+constexpr unsigned wheelMask(int ranks) { return (1u << (ranks - 1)) | 0xF; }
+
+// Straights best first: Ace high down to the wheel (A-2-3-4-5, or
+// A-6-7-8-9 in the short deck). Index of the best one in mask, or -1
+constexpr int straightIndex(unsigned mask, int ranks) {
+  unsigned runs = mask & (mask >> 1) & (mask >> 2) & (mask >> 3) & (mask >> 4);
+  if (runs)
+    return ranks - 5 - bitIndex(highestBit(runs));
+  return (mask & wheelMask(ranks)) == wheelMask(ranks) ? ranks - 4 : -1;
+}
+
+// Five distinct ranks that are not a straight, best first (flushes and
+// high cards share the order)
+constexpr int noStraightIndex(unsigned five, int ranks) {
+  int straightsAbove = wheelMask(ranks) > five;
+  for (int low = 0; low <= ranks - 5; low++)
+    straightsAbove += (0x1Fu << low) > five;
+  return subsetsAbove(five, (1u << ranks) - 1, 5) - straightsAbove;
+}
+
+// Best 5-card hand in one suit's rank mask (5+ cards)
+constexpr int flushRank(const RankLayout &l, unsigned mask) {
+  int straight = straightIndex(mask, l.ranks);
+  if (straight >= 0)
+    return l.straightFlush + straight;
+  return l.flush + noStraightIndex(topRanks(mask, 5), l.ranks);
+}
+
+// Rank counts as masks: the ranks held at least once, 4, 3 and 2 times
+struct RankMasks {
+  unsigned present = 0, quads = 0, trips = 0, pairs = 0;
+
+  constexpr RankMasks with(int rank, int count) const {
+    unsigned bit = 1u << rank;
+    RankMasks m = *this;
+    if (count > 0)
+      m.present |= bit;
+    if (count == 4)
+      m.quads |= bit;
+    else if (count == 3)
+      m.trips |= bit;
+    else if (count == 2)
+      m.pairs |= bit;
+    return m;
+  }
+};
+
+// Best 5-card hand from rank counts alone (5-7 cards, no flush)
+constexpr int countsRank(const RankLayout &l, const RankMasks &m) {
+  const unsigned all = (1u << l.ranks) - 1;
+  const int top = l.ranks - 1;
+  const unsigned present = m.present, quads = m.quads, trips = m.trips,
+                 pairs = m.pairs;
+
+  if (quads) {
+    unsigned rest = all & ~quads;
+    return l.quads + (top - bitIndex(quads)) * top +
+           subsetsAbove(topRanks(present & rest, 1), rest, 1);
+  }
+
+  // Two trips in 7 cards: the lower one plays as the pair
+  unsigned set = highestBit(trips);
+  unsigned pairsLeft = pairs | (trips & ~set);
+  if (set && pairsLeft) {
+    unsigned rest = all & ~set;
+    return l.fullHouse + (top - bitIndex(set)) * top +
+           subsetsAbove(highestBit(pairsLeft), rest, 1);
+  }
+
+  int straight = straightIndex(present, l.ranks);
+  if (straight >= 0)
+    return l.straight + straight;
+
+  if (set) {
+    unsigned rest = all & ~set;
+    return l.trips + (top - bitIndex(set)) * choose(top, 2) +
+           subsetsAbove(topRanks(present & rest, 2), rest, 2);
+  }
+
+  if (bitCount(pairs) >= 2) {
+    unsigned two = topRanks(pairs, 2);
+    unsigned rest = all & ~two;
+    return l.twoPair + subsetsAbove(two, all, 2) * (l.ranks - 2) +
+           subsetsAbove(topRanks(present & rest, 1), rest, 1);
+  }
+
+  if (pairs) {
+    unsigned rest = all & ~pairs;
+    return l.pair + (top - bitIndex(pairs)) * choose(top, 3) +
+           subsetsAbove(topRanks(present & rest, 3), rest, 3);
+  }
+
+  return l.highCard + noStraightIndex(topRanks(present, 5), l.ranks);
+}
+
+} // namespace tablegen
+
+// Everything a direct lookup needs, cache-line aligned and read-only:
+// - flushBest: best flush / straight flush for a suit mask (0 below 5
+//   cards)
+// - noFlush: best hand for every rank multiset of 5, 6 and 7 cards, the
+//   three tables back to back from noFlushStart[n], indexed by summing
+//   offsets[rank][cardsLeft][count] (colex order)
+// Both keep one spare entry so 32-bit SIMD gathers stay in bounds.
+template <int Ranks> struct alignas(64) RankTables {
+  static constexpr int NO_FLUSH_SIZE = tablegen::multisets(Ranks, 5) +
+                                       tablegen::multisets(Ranks, 6) +
+                                       tablegen::multisets(Ranks, 7);
+
+  alignas(64) short flushBest[(1 << Ranks) + 1] = {};
+  alignas(64) int offsets[Ranks][8][5] = {};
+  alignas(64) int noFlushStart[8] = {};
+  alignas(64) short noFlush[NO_FLUSH_SIZE + 1] = {};
+
+  constexpr explicit RankTables(const RankLayout &layout) {
+    for (unsigned mask = 0; mask < (1u << Ranks); mask++) {
+      if (tablegen::bitCount(mask) >= 5)
+        flushBest[mask] = static_cast<short>(tablegen::flushRank(layout, mask));
+    }
+
+    for (int r = 0; r < Ranks; r++) {
+      for (int n = 0; n < 8; n++) {
+        int before = 0;
+        for (int c = 0; c <= 4; c++) {
+          offsets[r][n][c] = before;
+          if (c <= n)
+            before += tablegen::multisets(Ranks - 1 - r, n - c);
+        }
+      }
+    }
+
+    noFlushStart[6] = tablegen::multisets(Ranks, 5);
+    noFlushStart[7] = noFlushStart[6] + tablegen::multisets(Ranks, 6);
+    for (int n = 5; n <= 7; n++)
+      fill(layout, tablegen::RankMasks{}, 0, n, n, 0);
+  }
+
+  // Colex index of a rank multiset, n = total cards
+  constexpr int index(const unsigned char *counts, int n) const {
+    int idx = 0;
+    for (int r = 0; r < Ranks; r++) {
+      idx += offsets[r][n][counts[r]];
+      n -= counts[r];
+    }
+    return idx;
+  }
+
+  // Best hand for n cards of these rank counts (5-7, no flush)
+  constexpr int ranksOnly(const unsigned char *counts, int n) const {
+    return noFlush[noFlushStart[n] + index(counts, n)];
+  }
+
+private:
+  // Every multiset of n cards (ranks below `rank` already in masks, idx
+  // their share of the index)
+  constexpr void fill(const RankLayout &layout, tablegen::RankMasks masks,
+                      int rank, int left, int n, int idx) {
+    if (rank == Ranks) {
+      noFlush[noFlushStart[n] + idx] =
+          static_cast<short>(tablegen::countsRank(layout, masks));
+      return;
+    }
+    if (left > 4 * (Ranks - rank))
+      return; // not enough ranks left for the cards
+    int last = rank == Ranks - 1 ? left : 0; // the top rank takes the rest
+    for (int c = last; c <= 4 && c <= left; c++)
+      fill(layout, masks.with(rank, c), rank + 1, left - c, n,
+           idx + offsets[rank][left][c]);
+  }
+};
+
+// Evaluator's tables (EvaluatorConstants.cpp)
+extern const RankTables<13> evaluatorTables;
 
 } // namespace poker
@@ -0,0 +1,177 @@
+#include "HandStrength.h"
+#include "BoardRankTable.h"
+#include "CardSet.h"
+#include "EquityCache.h"
+#include "Evaluator.h"
+#include "LruCache.h"
+#include "ThreadPool.h"
+#include <array>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace poker {
+
+using namespace std;
+
+// Runouts per pool task
+static const size_t kRunoutsPerChunk = 16;
+
+// Distinct spots kept, least recently used dropped first
+static mutex cacheMtx;
+static LruCache<string, HandStrength> cache(8192);
+
+// Hero vs one opponent combo
+enum Standing { AHEAD, TIED, BEHIND };
+
+static Standing standing(int hero, int opponent) {
+  return hero < opponent ? AHEAD : hero == opponent ? TIED : BEHIND;
+}
+
+// hp[now][river]: (opponent combo, runout) pairs by standing now and at
+// the river, plus the sum of squared river strengths
+struct PotentialTally {
+  array<array<long long, 3>, 3> hp{};
+  double hs2 = 0.0;
+
+  void add(const PotentialTally &other) {
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++)
+        hp[i][j] += other.hp[i][j];
+    }
+    hs2 += other.hs2;
+  }
+};
+
+void HandStrengthCalculator::clearCache() {
+  lock_guard<mutex> lock(cacheMtx);
+  cache.clear();
+}
+
+HandStrength HandStrengthCalculator::calculate(const vector<Card> &hand,
+                                               const vector<Card> &board,
+                                               const vector<Card> &dead) {
+  CardSet handSet = CardSet::fromCards(hand);
+  CardSet boardSet = CardSet::fromCards(board);
+  CardSet deadSet = CardSet::fromCards(dead);
+  if (hand.size() != 2 || handSet.size() != 2)
+    throw invalid_argument("Hand must have 2 different cards");
+  if (board.size() < 3 || board.size() > 5 ||
+      boardSet.size() != static_cast<int>(board.size()) ||
+      !(handSet & boardSet).empty())
+    throw invalid_argument("Board must be 3, 4 or 5 cards off the hand");
+  if (!((handSet | boardSet) & deadSet).empty())
+    throw invalid_argument("Dead cards must be off the hand and board");
+
+  vector<int> order;
+  string key = "HS" + EquityCache::canonicalKey({hand}, board, order, dead);
+  {
+    lock_guard<mutex> lock(cacheMtx);
+    HandStrength cached;
+    if (cache.get(key, cached))
+      return cached;
+  }
+
+  CardSet blocked = handSet | boardSet | deadSet;
+
+  // 1. Every opponent combo and where the hand stands against it now
+  vector<int> combos;
+  vector<CardSet> comboSets;
+  vector<Standing> now;
+  array<long long, 3> nowCount{};
+  int heroNow = Evaluator::evaluate(handSet | boardSet);
+  for (int combo = 0; combo < BoardRankTable::NUM_COMBOS; combo++) {
+    Card a, b;
+    BoardRankTable::comboCards(combo, a, b);
+    CardSet set(CardSet::bit(a) | CardSet::bit(b));
+    if (!(set & blocked).empty())
+      continue;
+    Standing s = standing(heroNow, Evaluator::evaluate(set | boardSet));
+    combos.push_back(combo);
+    comboSets.push_back(set);
+    now.push_back(s);
+    nowCount[s]++;
+  }
+
+  HandStrength result;
+  double total = static_cast<double>(combos.size());
+  result.hs = (nowCount[AHEAD] + nowCount[TIED] / 2.0) / total;
+
+  // 2. Every runout to the river (the river itself: one empty runout)
+  vector<Card> deck;
+  for (int idx = 0; idx < 52; idx++) {
+    Card c = BoardRankTable::cardFromIndex(idx);
+    if (!blocked.contains(c))
+      deck.push_back(c);
+  }
+  vector<vector<Card>> runouts;
+  if (board.size() == 5)
+    runouts.push_back({});
+  for (size_t i = 0; i < deck.size() && board.size() < 5; i++) {
+    if (board.size() == 4) {
+      runouts.push_back({deck[i]});
+      continue;
+    }
+    for (size_t j = i + 1; j < deck.size(); j++)
+      runouts.push_back({deck[i], deck[j]});
+  }
+
+  size_t numChunks = (runouts.size() + kRunoutsPerChunk - 1) / kRunoutsPerChunk;
+  vector<PotentialTally> chunkTallies(numChunks);
+  ThreadPool::instance().parallelFor(
+      runouts.size(), kRunoutsPerChunk, [&](size_t begin, size_t end) {
+        PotentialTally &tally = chunkTallies[begin / kRunoutsPerChunk];
+        vector<Card> river = board;
+        for (size_t r = begin; r < end; r++) {
+          river.resize(board.size());
+          river.insert(river.end(), runouts[r].begin(), runouts[r].end());
+          CardSet runoutSet = CardSet::fromCards(runouts[r]);
+
+          // One table ranks the hand and every opponent combo
+          BoardRankTable table(river);
+          int heroRank = table.rank(hand[0], hand[1]);
+          long long ahead = 0, tied = 0, live = 0;
+          for (size_t i = 0; i < combos.size(); i++) {
+            if (!(comboSets[i] & runoutSet).empty())
+              continue;
+            Standing s = standing(heroRank, table.rank(combos[i]));
+            tally.hp[now[i]][s]++;
+            ahead += s == AHEAD;
+            tied += s == TIED;
+            live++;
+          }
+          double riverHs = (ahead + tied / 2.0) / live;
+          tally.hs2 += riverHs * riverHs;
+        }
+      });
+
+  PotentialTally totals;
+  for (const auto &t : chunkTallies)
+    totals.add(t);
+
+  // 3. Potentials, ties counting half (0 when the hand can't be in that
+  // position, e.g. never behind)
+  auto row = [&](Standing s) {
+    return static_cast<double>(totals.hp[s][AHEAD] + totals.hp[s][TIED] +
+                               totals.hp[s][BEHIND]);
+  };
+  const auto &hp = totals.hp;
+  double behind = row(BEHIND) + row(TIED) / 2;
+  double ahead = row(AHEAD) + row(TIED) / 2;
+  if (behind > 0)
+    result.ppot =
+        (hp[BEHIND][AHEAD] + hp[BEHIND][TIED] / 2.0 + hp[TIED][AHEAD] / 2.0) /
+        behind;
+  if (ahead > 0)
+    result.npot =
+        (hp[AHEAD][BEHIND] + hp[TIED][BEHIND] / 2.0 + hp[AHEAD][TIED] / 2.0) /
+        ahead;
+  result.hs2 = totals.hs2 / runouts.size();
+  result.ehs = result.hs * (1 - result.npot) + (1 - result.hs) * result.ppot;
+
+  lock_guard<mutex> lock(cacheMtx);
+  cache.put(key, result);
+  return result;
+}
+
+} // namespace poker
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Card.h"
+#include <vector>
+
+namespace poker {
+
+// Classic hand-strength metrics of a hand vs one random opponent hand
+// (Billings et al.), all exact
+struct HandStrength {
+  double hs = 0.0;   // share of opponent hands beaten now (ties count half)
+  double hs2 = 0.0;  // E[HS^2] over the runouts (HS at the river, squared)
+  double ppot = 0.0; // P(ahead at the river | behind or tied now)
+  double npot = 0.0; // P(behind at the river | ahead or tied now)
+  double ehs = 0.0;  // effective strength: hs * (1 - npot) + (1 - hs) * ppot
+};
+
+class HandStrengthCalculator {
+public:
+  // Flop, turn or river (potentials are 0 on the river)
+  // Every runout is scored for every opponent combo with one
+  // BoardRankTable per runout (1081 on the flop, ~1M showdowns).
+  // Cached by canonical spot: suit renamings share an entry.
+  // dead: cards neither the opponent nor the board can have
+  // Throws std::invalid_argument for a bad hand, board or dead cards
+  static HandStrength calculate(const std::vector<Card> &hand,
+                                const std::vector<Card> &board,
+                                const std::vector<Card> &dead = {});
+
+  // Drops every cached result
+  static void clearCache();
+};
+
+} // namespace poker
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace poker {
+
+// Bounded map that drops the least recently used entry when full
+// Not thread-safe: owners lock around it (EquityCache, HandStrength).
+template <typename Key, typename Value> class LruCache {
+public:
+  explicit LruCache(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+  // Copies the value out and marks it most recently used
+  bool get(const Key &key, Value &value) {
+    auto it = index.find(key);
+    if (it == index.end())
+      return false;
+    entries.splice(entries.begin(), entries, it->second);
+    value = it->second->second;
+    return true;
+  }
+
+  // Keeps the first value stored under a key
+  void put(const Key &key, const Value &value) {
+    if (index.find(key) != index.end())
+      return;
+    entries.emplace_front(key, value);
+    index[key] = entries.begin();
+    if (entries.size() > capacity) {
+      index.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+
+  size_t size() const { return entries.size(); }
+
+  void clear() {
+    entries.clear();
+    index.clear();
+  }
+
+private:
+  using Entry = std::pair<Key, Value>;
+
+  size_t capacity;
+  std::list<Entry> entries; // most recently used first
+  std::unordered_map<Key, typename std::list<Entry>::iterator> index;
+};
+
+} // namespace poker
@@ -0,0 +1,82 @@
+#include "OutsAnalyzer.h"
+
+namespace poker {
+
+using namespace std;
+
+int OutsAnalyzer::leader(const vector<double> &equities) {
+  int best = -1;
+  bool tied = false;
+  for (int p = 0; p < static_cast<int>(equities.size()); p++) {
+    if (best < 0 || equities[p] > equities[best]) {
+      best = p;
+      tied = false;
+    } else if (equities[p] == equities[best]) {
+      tied = true;
+    }
+  }
+  return tied ? -1 : best;
+}
+
+OutsReport OutsAnalyzer::analyze(const vector<vector<Card>> &hands,
+                                 const vector<Card> &board,
+                                 const EquityOptions &options) {
+  OutsReport report;
+  report.byCard = EquityCalculator::calculateNextCard(hands, board, options);
+  report.cancelled = report.byCard[0].cancelled;
+  if (report.cancelled)
+    return report;
+
+  // Every card that can come is equally likely (and comes with as many
+  // runouts as any other), so now is the plain average
+  const int numPlayers = hands.size();
+  EquityResult &now = report.current;
+  now.equities.assign(numPlayers, 0.0);
+  now.stdErrors.assign(numPlayers, 0.0);
+  now.winRates.assign(numPlayers, 0.0);
+  now.tieRates.assign(numPlayers, 0.0);
+  now.categories.assign(numPlayers, {});
+  now.exact = true;
+  int cards = 0;
+  for (const auto &r : report.byCard) {
+    if (r.equities.empty())
+      continue;
+    for (int p = 0; p < numPlayers; p++) {
+      now.equities[p] += r.equities[p];
+      now.winRates[p] += r.winRates[p];
+      now.tieRates[p] += r.tieRates[p];
+      for (int c = 0; c < NUM_HAND_CATEGORIES; c++)
+        now.categories[p][c] += r.categories[p][c];
+    }
+    now.iterations += r.iterations;
+    cards++;
+  }
+  if (cards > 0) {
+    for (int p = 0; p < numPlayers; p++) {
+      now.equities[p] /= cards;
+      now.winRates[p] /= cards;
+      now.tieRates[p] /= cards;
+      for (double &share : now.categories[p])
+        share /= cards;
+    }
+    // On the flop each runout was counted for its turn and its river
+    now.iterations /= 5 - static_cast<long long>(board.size());
+  }
+  now.ciLow = now.equities;
+  now.ciHigh = now.equities;
+  report.equities = now.equities;
+
+  int leadNow = leader(report.equities);
+  report.outs.resize(numPlayers);
+  for (int idx = 0; idx < 52; idx++) {
+    const auto &r = report.byCard[idx];
+    if (r.equities.empty())
+      continue;
+    int leadAfter = leader(r.equities);
+    if (leadAfter >= 0 && leadAfter != leadNow)
+      report.outs[leadAfter].push_back(Card(idx / 4, idx % 4));
+  }
+  return report;
+}
+
+} // namespace poker
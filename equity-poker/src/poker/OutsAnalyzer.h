@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Card.h"
+#include "EquityCalculator.h"
+#include <vector>
+
+namespace poker {
+
+// What the next board card does to every player, on the flop or turn
+struct OutsReport {
+  std::vector<double> equities;     // now, per player
+  EquityResult current; // the same with win / tie rates and categories,
+                        // exact: what EquityCalculator::calculate gives
+  std::vector<EquityResult> byCard; // after each card (Rank * 4 + Suit),
+                                    // empty for cards that cannot come
+  // Per player: the cards that take them from behind to the best equity
+  // at the table (empty for whoever already leads)
+  std::vector<std::vector<Card>> outs;
+  bool cancelled = false; // stopped through EquityOptions::cancel
+};
+
+class OutsAnalyzer {
+public:
+  // One exact EquityCalculator::calculateNextCard pass: every runout is
+  // scored once and shared by all its cards. The current equities are the
+  // average over the next cards (current), so nothing else is enumerated.
+  // Throws std::invalid_argument unless the board has 3 or 4 cards
+  static OutsReport analyze(const std::vector<std::vector<Card>> &hands,
+                            const std::vector<Card> &board,
+                            const EquityOptions &options = EquityOptions());
+
+  // Index of the strictly best equity, or -1 on a tie for the lead
+  static int leader(const std::vector<double> &equities);
+};
+
+} // namespace poker
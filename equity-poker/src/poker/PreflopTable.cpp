@@ -0,0 +1,85 @@
+#include "PreflopTable.h"
+#include "BoardRankTable.h"
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace poker {
+
+static std::mutex configMtx;
+static std::string configuredPath = "preflop_equity.bin";
+static bool tableLoaded = false;
+
+const PreflopTable *PreflopTable::instance() {
+  static const PreflopTable *table = []() -> const PreflopTable * {
+    std::lock_guard<std::mutex> lock(configMtx);
+    tableLoaded = true;
+    // Never destroyed, like the thread pool
+    auto *t = new PreflopTable(configuredPath);
+    if (!t->loaded()) {
+      delete t;
+      return nullptr;
+    }
+    return t;
+  }();
+  return table;
+}
+
+bool PreflopTable::configure(const std::string &path) {
+  std::lock_guard<std::mutex> lock(configMtx);
+  if (tableLoaded)
+    return false;
+  configuredPath = path;
+  return true;
+}
+
+PreflopTable::PreflopTable(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != FILE_BYTES) {
+    close(fd);
+    return;
+  }
+
+  // Pages are only read in as lookups touch them
+  void *data = mmap(nullptr, FILE_BYTES, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return;
+
+  uint32_t header[4];
+  std::memcpy(header, data, sizeof(header));
+  if (header[0] != MAGIC || header[1] != VERSION ||
+      header[2] != static_cast<uint32_t>(NUM_COMBOS)) {
+    munmap(data, FILE_BYTES);
+    return;
+  }
+
+  mapping = data;
+  entries = reinterpret_cast<const uint16_t *>(static_cast<char *>(data) +
+                                               HEADER_BYTES);
+}
+
+PreflopTable::~PreflopTable() {
+  if (mapping)
+    munmap(mapping, FILE_BYTES);
+}
+
+double PreflopTable::equity(const Card &a1, const Card &a2, const Card &b1,
+                            const Card &b2) const {
+  if (!entries || a1 == a2 || b1 == b2 || a1 == b1 || a1 == b2 || a2 == b1 ||
+      a2 == b2)
+    return -1.0;
+
+  int a = BoardRankTable::comboIndex(a1, a2);
+  int b = BoardRankTable::comboIndex(b1, b2);
+  return entries[a * NUM_COMBOS + b] / 65535.0;
+}
+
+} // namespace poker
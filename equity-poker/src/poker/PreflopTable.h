@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Card.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace poker {
+
+// Exact heads-up preflop equity for every pair of hole-card combos,
+// precomputed offline (tools/GeneratePreflopTable.cpp) and memory-mapped.
+//
+// File layout (little endian):
+//   Header (16 bytes): magic "PFEQ", version, combo count (1326), unused
+//   1326 x 1326 uint16: equity of combo a vs combo b * 65535
+//                       (entry [a][b] at a * 1326 + b, 0 for shared cards)
+class PreflopTable {
+public:
+  static const uint32_t MAGIC = 0x51454650; // "PFEQ"
+  static const uint32_t VERSION = 1;
+  static const int NUM_COMBOS = 1326;
+  static const size_t HEADER_BYTES = 16;
+  static const size_t FILE_BYTES =
+      HEADER_BYTES + sizeof(uint16_t) * NUM_COMBOS * NUM_COMBOS;
+
+  // Maps the file read-only; loaded() is false if it is missing or invalid
+  explicit PreflopTable(const std::string &path);
+  ~PreflopTable();
+
+  PreflopTable(const PreflopTable &) = delete;
+  PreflopTable &operator=(const PreflopTable &) = delete;
+
+  // Table used by EquityCalculator, mapped on first use
+  // Returns nullptr when there is no usable file (callers simulate instead)
+  static const PreflopTable *instance();
+
+  // File for instance(), must be called before first use
+  // Default: "preflop_equity.bin" in the working directory
+  // Returns false if the table was already loaded
+  static bool configure(const std::string &path);
+
+  bool loaded() const { return entries != nullptr; }
+
+  // Equity of hand a vs hand b (ties count half), -1 if unknown
+  double equity(const Card &a1, const Card &a2, const Card &b1,
+                const Card &b2) const;
+
+private:
+  void *mapping = nullptr;
+  const uint16_t *entries = nullptr;
+};
+
+} // namespace poker
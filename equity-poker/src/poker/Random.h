@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Card.h"
+#include "CardSet.h"
+#include <cstdint>
+#include <limits>
+
+namespace poker {
+
+// xoshiro256** (Blackman & Vigna): tiny state, very fast, 2^256 period
+// Cheaper to seed and run than std::mt19937 in the equity hot loop.
+class FastRng {
+public:
+  using result_type = uint64_t;
+
+  explicit FastRng(uint64_t seed) {
+    // splitmix64 spreads the seed over the 256-bit state
+    for (auto &word : s) {
+      seed += 0x9e3779b97f4a7c15ULL;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  // Hands out this stream, then jumps to the next one: starting from
+  // FastRng(seed), calls give streams 0, 1, 2, ... of the seed (each
+  // 2^128 steps apart, so they never overlap) for one jump apiece
+  FastRng nextStream() {
+    FastRng current = *this;
+    jump();
+    return current;
+  }
+
+  uint64_t next() {
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+
+  // Uniform in [0, bound) (Lemire's multiply + reject, no modulo bias)
+  uint32_t below(uint32_t bound) {
+    uint64_t m = (next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < bound) {
+      uint32_t threshold = -bound % bound;
+      while (low < threshold) {
+        m = (next() >> 32) * bound;
+        low = static_cast<uint32_t>(m);
+      }
+    }
+    return static_cast<uint32_t>(m >> 32);
+  }
+
+  // Same as 2^128 calls to next()
+  void jump() {
+    static const uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t t[4] = {0, 0, 0, 0};
+    for (uint64_t word : JUMP) {
+      for (int b = 0; b < 64; b++) {
+        if (word & (1ULL << b)) {
+          for (int i = 0; i < 4; i++)
+            t[i] ^= s[i];
+        }
+        next();
+      }
+    }
+    for (int i = 0; i < 4; i++)
+      s[i] = t[i];
+  }
+
+  // UniformRandomBitGenerator (usable with std::shuffle etc)
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  uint64_t operator()() { return next(); }
+
+private:
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  uint64_t s[4];
+};
+
+// Partial Fisher-Yates: draws k random cards from deck[0..n) and moves
+// them to the front. Only k swaps, not a full shuffle.
+// The deck stays a valid permutation, so it can be reused for the next draw.
+inline CardSet drawCards(Card *deck, int n, int k, FastRng &rng) {
+  CardSet drawn;
+  for (int i = 0; i < k; i++) {
+    int j = i + rng.below(n - i);
+    Card tmp = deck[i];
+    deck[i] = deck[j];
+    deck[j] = tmp;
+    drawn.add(deck[i]);
+  }
+  return drawn;
+}
+
+} // namespace poker
@@ -0,0 +1,176 @@
+#include "Range.h"
+#include "BoardRankTable.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace poker {
+
+using namespace std;
+
+static const char RANK_CHARS[] = "23456789TJQKA";
+
+static int parseRank(char c) {
+  for (int r = 0; r < 13; r++) {
+    if (RANK_CHARS[r] == c)
+      return r;
+  }
+  return -1;
+}
+
+// "AKs" -> high A, low K, kind 's' ('o' offsuit, 'b' both / pair)
+struct HandClass {
+  int high = -1;
+  int low = -1;
+  char kind = 'b';
+  bool isPair() const { return high == low; }
+};
+
+static HandClass parseClass(const string &text, const string &token) {
+  if (text.size() != 2 && text.size() != 3)
+    throw invalid_argument("Bad range token: " + token);
+
+  HandClass hc;
+  hc.high = parseRank(text[0]);
+  hc.low = parseRank(text[1]);
+  if (hc.high < 0 || hc.low < 0)
+    throw invalid_argument("Bad range token: " + token);
+  if (hc.high < hc.low)
+    swap(hc.high, hc.low);
+
+  if (text.size() == 3) {
+    hc.kind = text[2];
+    if ((hc.kind != 's' && hc.kind != 'o') || hc.isPair())
+      throw invalid_argument("Bad range token: " + token);
+  }
+  return hc;
+}
+
+// Every combo of one hand class
+static void addClass(Range &range, int high, int low, char kind, float w) {
+  for (int s1 = 0; s1 < 4; s1++) {
+    for (int s2 = 0; s2 < 4; s2++) {
+      bool suited = s1 == s2;
+      bool skip = high == low ? s1 >= s2
+                              : (kind == 's' && !suited) ||
+                                    (kind == 'o' && suited);
+      if (skip)
+        continue;
+      range.add(Card(high, s1), Card(low, s2), w);
+    }
+  }
+}
+
+static void addToken(Range &range, const string &token) {
+  string body = token;
+  float w = 1.0f;
+
+  size_t colon = token.find(':');
+  if (colon != string::npos) {
+    body = token.substr(0, colon);
+    try {
+      size_t used = 0;
+      w = stof(token.substr(colon + 1), &used);
+      if (used != token.size() - colon - 1)
+        throw invalid_argument("trailing characters");
+    } catch (const exception &) {
+      throw invalid_argument("Bad range weight: " + token);
+    }
+    if (w < 0.0f || w > 1.0f)
+      throw invalid_argument("Range weight must be 0-1: " + token);
+  }
+
+  // One exact combo: AhKh
+  if (body.size() == 4 && parseRank(body[1]) < 0) {
+    Card a, b;
+    try {
+      a = Card::fromString(body.substr(0, 2));
+      b = Card::fromString(body.substr(2, 2));
+    } catch (const exception &) {
+      throw invalid_argument("Bad range token: " + token);
+    }
+    if (a == b)
+      throw invalid_argument("Bad range token: " + token);
+    range.add(a, b, w);
+    return;
+  }
+
+  // TT+ (pairs up to AA), ATs+ (kicker up to one below the top card)
+  if (!body.empty() && body.back() == '+') {
+    HandClass hc = parseClass(body.substr(0, body.size() - 1), token);
+    int top = hc.isPair() ? 12 : hc.high - 1;
+    for (int r = hc.low; r <= top; r++)
+      addClass(range, hc.isPair() ? r : hc.high, r, hc.kind, w);
+    return;
+  }
+
+  // 22-55, A5s-A2s
+  size_t dash = body.find('-');
+  if (dash != string::npos) {
+    HandClass from = parseClass(body.substr(0, dash), token);
+    HandClass to = parseClass(body.substr(dash + 1), token);
+    if (from.isPair() != to.isPair() || from.kind != to.kind ||
+        (!from.isPair() && from.high != to.high))
+      throw invalid_argument("Bad range span: " + token);
+
+    int lo = min(from.low, to.low);
+    int hi = max(from.low, to.low);
+    for (int r = lo; r <= hi; r++)
+      addClass(range, from.isPair() ? r : from.high, r, from.kind, w);
+    return;
+  }
+
+  HandClass hc = parseClass(body, token);
+  addClass(range, hc.high, hc.low, hc.kind, w);
+}
+
+Range Range::parse(const string &text) {
+  string spaced = text;
+  replace(spaced.begin(), spaced.end(), ',', ' ');
+
+  Range range;
+  istringstream tokens(spaced);
+  string token;
+  while (tokens >> token)
+    addToken(range, token);
+  return range;
+}
+
+Range Range::all() {
+  Range range;
+  range.weights.fill(1.0f);
+  return range;
+}
+
+Range Range::fromHand(const Card &a, const Card &b) {
+  Range range;
+  range.add(a, b);
+  return range;
+}
+
+void Range::add(const Card &a, const Card &b, float w) {
+  weights[BoardRankTable::comboIndex(a, b)] = w;
+}
+
+void Range::removeCards(CardSet dead) {
+  for (int combo = 0; combo < NUM_COMBOS; combo++) {
+    Card a, b;
+    BoardRankTable::comboCards(combo, a, b);
+    if (dead.contains(a) || dead.contains(b))
+      weights[combo] = 0.0f;
+  }
+}
+
+int Range::size() const {
+  return count_if(weights.begin(), weights.end(),
+                  [](float w) { return w > 0.0f; });
+}
+
+double Range::totalWeight() const {
+  double total = 0.0;
+  for (float w : weights)
+    total += w;
+  return total;
+}
+
+} // namespace poker
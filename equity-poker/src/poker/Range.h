@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Card.h"
+#include "CardSet.h"
+#include <array>
+#include <string>
+
+namespace poker {
+
+// Weighted set of hole-card combos: one weight (0.0 - 1.0) per combo,
+// indexed like BoardRankTable::comboIndex
+class Range {
+public:
+  static const int NUM_COMBOS = 1326;
+
+  Range() { weights.fill(0.0f); }
+
+  // Standard notation, comma or space separated:
+  //   AA  AKs  AKo  AK      hand classes (AK = suited + offsuit)
+  //   TT+  ATs+  KTo+       pairs up to AA / kicker up to one below the top
+  //   22-55  A5s-A2s        spans
+  //   AhKh                  one exact combo
+  //   AKs:0.5               any token with a weight
+  // Throws std::invalid_argument on bad input
+  static Range parse(const std::string &text);
+
+  // Every combo at weight 1 (a random hand)
+  static Range all();
+
+  // A single known hand
+  static Range fromHand(const Card &a, const Card &b);
+
+  float weight(int combo) const { return weights[combo]; }
+  void setWeight(int combo, float w) { weights[combo] = w; }
+  void add(const Card &a, const Card &b, float w = 1.0f);
+
+  // Card removal: zero every combo that uses one of these cards
+  void removeCards(CardSet dead);
+
+  // Combos with a weight above zero
+  int size() const;
+  bool empty() const { return size() == 0; }
+  double totalWeight() const;
+
+private:
+  std::array<float, NUM_COMBOS> weights;
+};
+
+} // namespace poker
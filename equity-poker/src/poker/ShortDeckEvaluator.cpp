@@ -0,0 +1,90 @@
+#include "ShortDeckEvaluator.h"
+#include "EvaluatorBatch.h"
+#include "EvaluatorConstants.h"
+#include <initializer_list>
+#include <stdexcept>
+
+namespace poker {
+
+namespace {
+
+// 9 ranks: bit / index 0 = the 6 ... 8 = the Ace
+constexpr int kLowestRank = Card::RANK_6;
+constexpr const RankLayout &kLayout = kShortDeckLayout;
+
+// Built by the compiler, like the full-deck tables
+constexpr RankTables<9> kTables(kShortDeckLayout);
+
+// A few spot checks, so a broken generator fails the build
+constexpr int countsOf(int r0, int r1, int r2, int r3, int r4) {
+  unsigned char counts[9] = {};
+  for (int r : {r0, r1, r2, r3, r4})
+    counts[r]++;
+  return kTables.ranksOnly(counts, 5);
+}
+static_assert(kTables.flushBest[0x1F0] == 1, "royal flush is rank 1");
+static_assert(kTables.flushBest[0x10F] == 6, "A6789 is the lowest SF");
+static_assert(kTables.flushBest[0x1E8] == kLayout.flush, "AKQJ9 best flush");
+static_assert(countsOf(8, 8, 8, 8, 7) == kLayout.quads, "AAAAK best quads");
+static_assert(countsOf(8, 8, 8, 7, 7) == kLayout.fullHouse, "AAAKK best boat");
+static_assert(countsOf(8, 0, 1, 2, 3) == kLayout.straight + 5, "wheel");
+static_assert(countsOf(0, 0, 1, 1, 2) == kLayout.twoPair + 251, "77668");
+static_assert(countsOf(4, 3, 2, 1, 0) == kLayout.straight + 4, "T-high");
+static_assert(countsOf(5, 3, 2, 1, 0) == ShortDeckEvaluator::NUM_RANKS,
+              "J-9-8-7-6 is the worst hand");
+
+} // namespace
+
+int ShortDeckEvaluator::evaluate(const std::vector<Card> &cards) {
+  CardSet set = CardSet::fromCards(cards);
+  if (cards.size() < 5 || cards.size() > 7 ||
+      set.size() != static_cast<int>(cards.size()))
+    throw std::invalid_argument("Short deck needs 5-7 different cards");
+  for (const auto &c : cards) {
+    if (!inDeck(c))
+      throw std::invalid_argument("Not a short-deck card: " + c.toString());
+  }
+  return evaluate(set);
+}
+
+int ShortDeckEvaluator::evaluate(CardSet cards) {
+  // A suit lane's bits 4-12 are its 6 to Ace
+  for (int s = 0; s < 4; s++) {
+    unsigned mask = cards.suitMask(s) >> kLowestRank;
+    if (tablegen::bitCount(mask) >= 5)
+      return kTables.flushBest[mask];
+  }
+
+  unsigned char counts[9] = {};
+  for (Card c : cards)
+    counts[c.rank() - kLowestRank]++;
+  return kTables.ranksOnly(counts, cards.size());
+}
+
+void ShortDeckEvaluator::evaluateBatch(const CardSet *hands, int n, int *out) {
+  // The full-deck AVX2 path over the 9-rank tables
+  batch::evaluate(kTables, kLowestRank, hands, n, out,
+                  [](CardSet hand) { return evaluate(hand); });
+}
+
+HandCategory ShortDeckEvaluator::category(int rank) {
+  if (rank < kLayout.quads)
+    return HandCategory::StraightFlush;
+  if (rank < kLayout.flush)
+    return HandCategory::FourOfAKind;
+  if (rank < kLayout.fullHouse)
+    return HandCategory::Flush;
+  if (rank < kLayout.straight)
+    return HandCategory::FullHouse;
+  if (rank < kLayout.trips)
+    return HandCategory::Straight;
+  if (rank < kLayout.twoPair)
+    return HandCategory::ThreeOfAKind;
+  if (rank < kLayout.pair)
+    return HandCategory::TwoPair;
+  if (rank < kLayout.highCard)
+    return HandCategory::OnePair;
+  return HandCategory::HighCard;
+}
+
+} // namespace poker
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Card.h"
+#include "CardSet.h"
+#include "Evaluator.h"
+#include <vector>
+
+namespace poker {
+
+// Short-deck (6+) Hold'em hand evaluator
+// 36 cards (6 to Ace), A-6-7-8-9 is the lowest straight and a flush beats
+// a full house. Ranks work like Evaluator's (1 = royal flush, lower is
+// better) but there are only 1404 distinct hands and the lookup tables
+// are generated at compile time, see EvaluatorConstants.h
+class ShortDeckEvaluator {
+public:
+  static const int NUM_RANKS = 1404;
+
+  // The 36 short-deck cards
+  static bool inDeck(const Card &c) { return c.rank() >= Card::RANK_6; }
+
+  // 5, 6 or 7 short-deck cards
+  // Throws std::invalid_argument otherwise
+  static int evaluate(const std::vector<Card> &cards);
+
+  // Unchecked, same lookups as above (5-7 short-deck cards)
+  static int evaluate(CardSet cards);
+
+  // out[i] = evaluate(hands[i])
+  static void evaluateBatch(const CardSet *hands, int n, int *out);
+
+  // Categories in short-deck order (Flush before FullHouse)
+  static HandCategory category(int rank);
+};
+
+} // namespace poker
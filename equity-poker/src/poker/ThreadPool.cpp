@@ -0,0 +1,170 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+namespace poker {
+
+static std::mutex configMtx;
+static int configuredSize = 0;
+static bool poolCreated = false;
+
+ThreadPool &ThreadPool::instance() {
+  static ThreadPool *pool = [] {
+    std::lock_guard<std::mutex> lock(configMtx);
+    poolCreated = true;
+    int n = configuredSize;
+    if (n <= 0)
+      n = std::thread::hardware_concurrency();
+    if (n <= 0)
+      n = 4;
+    // Never destroyed: workers may still be running at process exit
+    return new ThreadPool(n);
+  }();
+  return *pool;
+}
+
+bool ThreadPool::configure(int numThreads) {
+  std::lock_guard<std::mutex> lock(configMtx);
+  if (poolCreated)
+    return false;
+  configuredSize = numThreads;
+  return true;
+}
+
+ThreadPool::ThreadPool(int numThreads) {
+  numThreads = std::max(1, numThreads);
+  for (int i = 0; i < numThreads; i++)
+    queues.push_back(std::make_unique<WorkQueue>());
+  for (int i = 0; i < numThreads; i++)
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMtx);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for (auto &w : workers)
+    w.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  // Spread external work round robin, workers steal to rebalance
+  // (count first so pendingTasks never dips below the queued work)
+  unsigned q = nextQueue.fetch_add(1) % queues.size();
+  {
+    std::lock_guard<std::mutex> lock(sleepMtx);
+    pendingTasks++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues[q]->mtx);
+    queues[q]->tasks.push_back(std::move(task));
+  }
+  wakeUp.notify_one();
+}
+
+bool ThreadPool::popTask(int self, std::function<void()> &task) {
+  // 1. Own queue (newest first, still warm in cache)
+  {
+    WorkQueue &own = *queues[self];
+    std::lock_guard<std::mutex> lock(own.mtx);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // 2. Steal the oldest task from someone else
+  int n = queues.size();
+  for (int i = 1; i < n; i++) {
+    WorkQueue &other = *queues[(self + i) % n];
+    std::lock_guard<std::mutex> lock(other.mtx);
+    if (!other.tasks.empty()) {
+      task = std::move(other.tasks.front());
+      other.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::workerLoop(int self) {
+  while (true) {
+    std::function<void()> task;
+    if (popTask(self, task)) {
+      pendingTasks--;
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMtx);
+    wakeUp.wait(lock, [this] { return stopping || pendingTasks > 0; });
+    if (stopping)
+      return;
+  }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t chunkSize,
+                             const std::function<void(size_t, size_t)> &body) {
+  if (count == 0)
+    return;
+  chunkSize = std::max<size_t>(1, chunkSize);
+  size_t numChunks = (count + chunkSize - 1) / chunkSize;
+
+  // One chunk: no point waking anyone
+  if (numChunks == 1) {
+    body(0, count);
+    return;
+  }
+
+  // Shared by the caller and the helpers; helpers that start late just
+  // find no chunks left
+  struct Job {
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> chunksDone{0};
+    std::mutex mtx;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+  auto job = std::make_shared<Job>();
+
+  auto runChunks = [job, count, chunkSize, numChunks, &body] {
+    while (true) {
+      size_t chunk = job->nextChunk.fetch_add(1);
+      if (chunk >= numChunks)
+        return;
+
+      size_t begin = chunk * chunkSize;
+      size_t end = std::min(count, begin + chunkSize);
+      try {
+        body(begin, end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(job->mtx);
+        if (!job->error)
+          job->error = std::current_exception();
+      }
+
+      if (job->chunksDone.fetch_add(1) + 1 == numChunks) {
+        std::lock_guard<std::mutex> lock(job->mtx);
+        job->done.notify_all();
+      }
+    }
+  };
+
+  // body is only touched while chunks remain, and we do not return
+  // before every chunk is done, so capturing it by reference is safe
+  size_t helpers = std::min(numChunks - 1, workers.size());
+  for (size_t i = 0; i < helpers; i++)
+    submit(runChunks);
+
+  runChunks();
+
+  std::unique_lock<std::mutex> lock(job->mtx);
+  job->done.wait(lock, [&] { return job->chunksDone == numChunks; });
+  if (job->error)
+    std::rethrow_exception(job->error);
+}
+
+} // namespace poker
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace poker {
+
+// Persistent worker pool with work stealing
+// Each worker owns a task deque: it pops its own work from the back and
+// steals from the front of the others when it runs dry.
+class ThreadPool {
+public:
+  explicit ThreadPool(int numThreads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Process-wide pool used by the equity engine (created on first use)
+  static ThreadPool &instance();
+
+  // Size of the process-wide pool, must be called before instance()
+  // 0 = one worker per hardware thread
+  // Returns false if the pool already exists
+  static bool configure(int numThreads);
+
+  int size() const { return static_cast<int>(workers.size()); }
+
+  // Queue a standalone task
+  void submit(std::function<void()> task);
+
+  // Runs body(begin, end) over [0, count) in chunks of chunkSize.
+  // The calling thread works on chunks too, so this is safe to call from
+  // inside a pool task. Returns once every chunk has finished.
+  void parallelFor(size_t count, size_t chunkSize,
+                   const std::function<void(size_t, size_t)> &body);
+
+private:
+  struct WorkQueue {
+    std::mutex mtx;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void workerLoop(int self);
+  bool popTask(int self, std::function<void()> &task);
+
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  std::vector<std::thread> workers;
+
+  // Sleeping workers wait here until new work arrives
+  std::mutex sleepMtx;
+  std::condition_variable wakeUp;
+  std::atomic<int> pendingTasks{0};
+  std::atomic<unsigned> nextQueue{0};
+  bool stopping = false;
+};
+
+} // namespace poker
@@ -1,6 +1,15 @@
 #include "App.h"
+#include "EquityCache.h"
+#include "EquityScheduler.h"
 #include "Lobby.h"
+#include "PreflopTable.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <random>
 #include <string>
@@ -18,6 +27,20 @@ constexpr const char *kErrStaleConnection = "STALE_CONNECTION";
 constexpr const char *kErrBadPayload = "BAD_PAYLOAD";
 constexpr const char *kErrInternalError = "INTERNAL_ERROR";
 
+// Minimum gap between coarse equity updates while a job refines
+constexpr int kEquityRefreshMs = 100;
+// An equity job not started by then is dropped (the table has moved on)
+constexpr int kEquityDeadlineMs = 2000;
+// This table's queue in the EquityScheduler
+constexpr const char *kEquityRoom = "table";
+
+// Each requester's heatmaps get their own EquityScheduler queue: a new
+// request replaces the pending one and cancels the running one, and the
+// table's live equity still gets its turn
+std::string heatmapRoom(const std::string &userId) {
+  return "heatmap:" + userId;
+}
+
 } // namespace
 
 struct PerSocketData {
@@ -31,7 +54,22 @@ poker::Lobby lobby;
 std::unordered_map<std::string, WebSocket *> connectedSockets;
 std::unordered_map<WebSocket *, std::string> socketOwners;
 json spectatorEquityCache = json::object();
+// Extra spectator fields that come with the final equities:
+// equityBreakdown (win / tie / hand categories) and outs (flop / turn)
+json spectatorDetailsCache = json::object();
 bool hasSpectatorEquityCache = false;
+// userId -> own equity vs random hands, for players who opted in
+json heroEquityCache = json::object();
+
+// Equity runs on the thread pool and is posted back to this loop
+uWS::Loop *mainLoop = nullptr;
+// Latest equity job: starting a new one cancels the one before
+uint64_t latestEquityJob = 0;
+// Equity work asked for during the current loop tick; it is submitted
+// once, for the latest state, when the tick's events are done
+bool equityJobPending = false;
+bool equityJobDeferred = false;
+bool equityJobForSpectators = false;
 
 bool isCurrentSocketForUser(WebSocket *ws, const std::string &userId) {
   auto it = connectedSockets.find(userId);
@@ -117,25 +155,167 @@ void bindSocketToUser(WebSocket *ws, const std::string &userId) {
   ws->getUserData()->userId = userId;
 }
 
+// Push fresh equities to spectators (players never see them)
+// final = false for the coarse estimates sent while sampling
+void sendEquityUpdate(const json &equities, const json &details,
+                      bool final) {
+  json data = details;
+  data["equities"] = equities;
+  data["final"] = final;
+  std::string payload = makeEventEnvelope("equity_update", data).dump();
+  for (auto &[userId, ws] : connectedSockets) {
+    if (lobby.isSpectator(userId))
+      ws->send(payload, uWS::OpCode::TEXT);
+  }
+}
+
+// Each opted-in player gets only their own number
+void sendHeroEquityUpdate(const json &heroEquities) {
+  for (auto &[userId, ws] : connectedSockets) {
+    if (!heroEquities.contains(userId))
+      continue;
+    json data = json::object();
+    data["heroEquity"] = heroEquities[userId];
+    data["final"] = true;
+    sendJson(ws, makeEventEnvelope("equity_update", data));
+  }
+}
+
+// Runs on the loop: keep the latest numbers and tell spectators, unless
+// a newer job has started since
+void postEquityUpdate(uint64_t jobId, json equities, bool final,
+                      json details = json::object()) {
+  mainLoop->defer([jobId, equities = std::move(equities), final,
+                   details = std::move(details)] {
+    if (jobId != latestEquityJob || !lobby.getLobbyConfig().godMode)
+      return;
+    spectatorEquityCache = equities;
+    spectatorDetailsCache = details;
+    hasSpectatorEquityCache = true;
+    sendEquityUpdate(spectatorEquityCache, spectatorDetailsCache, final);
+  });
+}
+
+void postHeroEquityUpdate(uint64_t jobId, json heroEquities) {
+  mainLoop->defer([jobId, heroEquities = std::move(heroEquities)] {
+    if (jobId != latestEquityJob)
+      return;
+    heroEquityCache = heroEquities;
+    sendHeroEquityUpdate(heroEquityCache);
+  });
+}
+
+// Nothing still in flight gets posted after this
+void cancelEquityJob() {
+  poker::EquityScheduler::instance().cancel(kEquityRoom);
+  equityJobPending = false;
+  ++latestEquityJob;
+}
+
+// Simulates on the pool; a coarse estimate goes out after the first few
+// thousand iterations, then refinements at most every
+// kEquityRefreshMs until the result converges. Hero equities follow,
+// one batch for every opted-in player. Queued in the EquityScheduler,
+// which may cut the sampling budget when it is overloaded.
+void runEquityJob() {
+  equityJobDeferred = false;
+  if (!equityJobPending)
+    return;
+  equityJobPending = false;
+  bool spectators = equityJobForSpectators;
+  uint64_t jobId = latestEquityJob;
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(kEquityDeadlineMs);
+  poker::EquityScheduler::instance().submit(
+      kEquityRoom, deadline,
+      [jobId, spectators, request = lobby.equityRequest()](
+          const poker::EquityBudget &budget) {
+        const std::atomic<bool> *cancel = budget.cancel;
+        double precision = -1.0;
+        auto lastSent = std::chrono::steady_clock::time_point();
+        auto onProgress = [&](const json &partial) {
+          auto now = std::chrono::steady_clock::now();
+          if (now - lastSent < std::chrono::milliseconds(kEquityRefreshMs))
+            return;
+          lastSent = now;
+          postEquityUpdate(jobId, partial, false);
+        };
+
+        try {
+          if (spectators) {
+            json details = json::object();
+            json equities;
+            // Flop / turn: one pass over the runouts gives the equities
+            // and the per-card table for the next street (a few ms, then
+            // cached for the rest of the street)
+            json outs = poker::Lobby::computeOuts(
+                request, cancel, &equities, &details["equityBreakdown"]);
+            if (*cancel)
+              return -1.0;
+            if (!outs.empty()) {
+              details["outs"] = std::move(outs);
+              precision = 0.0;
+            } else {
+              equities = poker::Lobby::computeEquities(
+                  request, cancel, onProgress, &details["equityBreakdown"],
+                  budget.scale, &precision);
+              if (*cancel)
+                return -1.0;
+            }
+            postEquityUpdate(jobId, std::move(equities), true,
+                             std::move(details));
+          }
+          if (!request.heroes.empty()) {
+            json heroEquities = poker::Lobby::computeHeroEquities(
+                request, cancel, budget.scale);
+            if (*cancel)
+              return -1.0;
+            postHeroEquityUpdate(jobId, std::move(heroEquities));
+          }
+        } catch (const std::exception &e) {
+          std::cerr << "Equity job failed: " << e.what() << std::endl;
+        }
+        return precision;
+      });
+}
+
+// Several state changes in one tick (an action, then the street being
+// dealt) would each start and cancel a job: only the last one runs
+void startEquityJob(bool spectators) {
+  cancelEquityJob();
+  equityJobPending = true;
+  equityJobForSpectators = spectators;
+  if (equityJobDeferred)
+    return;
+  equityJobDeferred = true;
+  mainLoop->defer(runEquityJob);
+}
+
 // Send personalised state to every connected client
+// Never waits for equity: with includeEquities a background job is
+// started and spectators get an equity_update event when it is done
 void broadcastToAll(bool includeEquities = true) {
-  json cachedEquities;
   json *equitiesPtr = nullptr;
+  bool godMode = lobby.getLobbyConfig().godMode;
 
-  // Pre-calculate equities if God Mode is active
-  // avoids running Monte Carlo sim for every spectator
-  if (lobby.getLobbyConfig().godMode) {
-    if (includeEquities) {
-      cachedEquities = lobby.computeEquities();
-      spectatorEquityCache = cachedEquities;
-      hasSpectatorEquityCache = true;
-      equitiesPtr = &cachedEquities;
-    } else if (hasSpectatorEquityCache) {
-      equitiesPtr = &spectatorEquityCache;
-    }
-  } else {
+  if (includeEquities) {
+    // The old numbers belong to the previous state
+    hasSpectatorEquityCache = false;
+    spectatorEquityCache = json::object();
+    spectatorDetailsCache = json::object();
+    heroEquityCache = json::object();
+    if (godMode || !lobby.equityRequest().heroes.empty())
+      startEquityJob(godMode);
+    else
+      cancelEquityJob();
+  } else if (godMode && hasSpectatorEquityCache) {
+    equitiesPtr = &spectatorEquityCache;
+  }
+  if (!godMode) {
     hasSpectatorEquityCache = false;
     spectatorEquityCache = json::object();
+    spectatorDetailsCache = json::object();
   }
 
   std::string spectatorPayload;
@@ -146,18 +326,19 @@ void broadcastToAll(bool includeEquities = true) {
     // string.
     if (lobby.isSpectator(userId)) {
       if (!spectatorPayloadReady) {
-        json msg = makeEventEnvelope("game_state",
-                                     lobby.toJsonForViewer("", includeEquities,
-                                                           equitiesPtr));
+        json state = lobby.toJsonForViewer("", false, equitiesPtr);
+        if (equitiesPtr)
+          state.update(spectatorDetailsCache);
+        json msg = makeEventEnvelope("game_state", state);
         spectatorPayload = msg.dump();
         spectatorPayloadReady = true;
       }
       ws->send(spectatorPayload, uWS::OpCode::TEXT);
     } else {
       // Active players need unique views
-      json msg = makeEventEnvelope("game_state",
-                                   lobby.toJsonForViewer(userId, includeEquities,
-                                                         equitiesPtr));
+      json msg = makeEventEnvelope(
+          "game_state", lobby.toJsonForViewer(userId, false, equitiesPtr,
+                                              &heroEquityCache));
       sendJson(ws, msg);
     }
   }
@@ -432,6 +613,106 @@ ActionResult handleChat(const ActionContext &ctx) {
   return makeSuccess();
 }
 
+ActionResult handleSetHeroEquity(const ActionContext &ctx) {
+  ActionResult error;
+  bool enabled = false;
+  if (!readRequiredBool(ctx.data, "enabled", enabled, error)) {
+    return error;
+  }
+
+  if (!lobby.setHeroEquity(ctx.userData->userId, enabled)) {
+    return makeError(kErrInvalidAction, "Unknown user");
+  }
+
+  ActionResult result = makeSuccess();
+  result.includeEquitiesInBroadcast = true;
+  return result;
+}
+
+// Equity scheduler and cache counters, for monitoring
+ActionResult handleEquityMetrics(const ActionContext & /*ctx*/) {
+  auto scheduler = poker::EquityScheduler::instance().metrics();
+  auto cache = poker::EquityCache::instance().stats();
+  ActionResult result = makeSuccess();
+  result.data["queueDepth"] = scheduler.queueDepth;
+  result.data["running"] = scheduler.running;
+  result.data["completed"] = scheduler.completed;
+  result.data["coalesced"] = scheduler.coalesced;
+  result.data["shed"] = scheduler.shed;
+  result.data["degraded"] = scheduler.degraded;
+  result.data["failed"] = scheduler.failed;
+  result.data["lastBudget"] = scheduler.lastBudget;
+  result.data["lastPrecision"] = scheduler.lastPrecision;
+  result.data["meanPrecision"] = scheduler.meanPrecision;
+  result.data["cacheHits"] = cache.hits;
+  result.data["cacheMisses"] = cache.misses;
+  result.data["cacheSize"] = cache.size;
+  return result;
+}
+
+// Heatmap of a seat's hand (own seat, or any for god-mode spectators) or
+// of any hand given as two card strings, against all 169 classes on the
+// current board. Queued in the requester's EquityScheduler slot, the
+// requester gets an equity_heatmap event.
+ActionResult handleEquityHeatmap(const ActionContext &ctx) {
+  ActionResult error;
+  poker::HeatmapRequest request;
+  int seatIndex = -1;
+  if (!readOptionalInt(ctx.data, "seatIndex", seatIndex, error)) {
+    return error;
+  }
+
+  auto handIt = ctx.data.find("hand");
+  if (handIt != ctx.data.end()) {
+    if (!handIt->is_array() || handIt->size() != 2 ||
+        !(*handIt)[0].is_string() || !(*handIt)[1].is_string()) {
+      return makeError(kErrBadPayload, "Field 'hand' must be two card strings");
+    }
+    try {
+      for (const auto &card : *handIt)
+        request.hand.push_back(poker::Card::fromString(card.get<std::string>()));
+    } catch (const std::exception &) {
+      return makeError(kErrBadPayload, "Field 'hand' has an invalid card");
+    }
+    request.board = lobby.getGame().getBoard();
+    auto used = poker::CardSet::fromCards(request.hand) |
+                poker::CardSet::fromCards(request.board);
+    if (used.size() != static_cast<int>(request.hand.size() +
+                                         request.board.size())) {
+      return makeError(kErrBadPayload, "Hand clashes with the board");
+    }
+  } else if (!lobby.heatmapRequest(ctx.userData->userId, seatIndex,
+                                   request)) {
+    return makeError(kErrInvalidAction, "No visible hand in that seat");
+  }
+
+  std::string userId = ctx.userData->userId;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(kEquityDeadlineMs);
+  poker::EquityScheduler::instance().submit(
+      heatmapRoom(userId), deadline,
+      [userId, seatIndex, request](const poker::EquityBudget &budget) {
+        json heatmap;
+        try {
+          heatmap = poker::Lobby::computeHeatmap(request, budget.cancel);
+        } catch (const std::exception &e) {
+          std::cerr << "Heatmap job failed: " << e.what() << std::endl;
+          return -1.0;
+        }
+        if (heatmap.empty())
+          return -1.0; // superseded by a newer request
+        heatmap["seatIndex"] = seatIndex;
+        mainLoop->defer([userId, heatmap = std::move(heatmap)] {
+          auto it = connectedSockets.find(userId);
+          if (it != connectedSockets.end())
+            sendJson(it->second, makeEventEnvelope("equity_heatmap", heatmap));
+        });
+        return -1.0;
+      });
+
+  return makeSuccess();
+}
+
 ActionResult handleUpdateConfig(const ActionContext &ctx) {
   ActionResult error;
   poker::LobbyConfig newConfig = lobby.getLobbyConfig();
@@ -456,6 +737,9 @@ ActionResult handleUpdateConfig(const ActionContext &ctx) {
   if (!readOptionalBool(ctx.data, "godMode", newConfig.godMode, error)) {
     return error;
   }
+  if (!readOptionalBool(ctx.data, "shortDeck", newConfig.shortDeck, error)) {
+    return error;
+  }
   if (!readOptionalString(ctx.data, "roomCode", newConfig.roomCode, error)) {
     return error;
   }
@@ -528,6 +812,9 @@ const std::unordered_map<std::string, ActionHandler> &getActionHandlers() {
       {"muck_show", handleMuckShow},
       {"rebuy", handleRebuy},
       {"chat", handleChat},
+      {"set_hero_equity", handleSetHeroEquity},
+      {"equity_heatmap", handleEquityHeatmap},
+      {"equity_metrics", handleEquityMetrics},
       {"update_config", handleUpdateConfig},
       {"end_game", handleEndGame},
       {"kick_player", handleKickPlayer},
@@ -616,6 +903,17 @@ json makeResponseEnvelope(const std::string &requestId,
 int main() {
   std::cout << "Starting Game Server on port 9001..." << std::endl;
 
+  // Equity workers leave one core free for the uWS event loop
+  int equityThreads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+  poker::ThreadPool::configure(std::max(1, equityThreads));
+
+  // Heads-up preflop table (build with the preflop_table target), mapped
+  // on the first preflop equity request. Without it preflop is simulated.
+  if (const char *tablePath = std::getenv("PREFLOP_TABLE"))
+    poker::PreflopTable::configure(tablePath);
+
+  mainLoop = uWS::Loop::get();
+
   uWS::App()
       .ws<PerSocketData>(
           "/*",
@@ -703,6 +1001,9 @@ int main() {
                  if (userData->userId == userId) {
                    userData->userId.clear();
                  }
+                 // Nobody left to send their heatmap to
+                 poker::EquityScheduler::instance().cancel(
+                     heatmapRoom(userId));
 
                  std::cout << "Client disconnected: " << userId << std::endl;
                  lobby.disconnectPlayer(userId);
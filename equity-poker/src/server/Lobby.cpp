@@ -1,6 +1,14 @@
 #include "Lobby.h"
+#include "../poker/EquityCache.h"
 #include "../poker/EquityCalculator.h"
+#include "../poker/EquityHeatmap.h"
+#include "../poker/EquityScheduler.h"
+#include "../poker/LruCache.h"
+#include "../poker/OutsAnalyzer.h"
+#include "../poker/ThreadPool.h"
+#include <algorithm>
 #include <chrono>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <unordered_set>
 
@@ -19,6 +27,12 @@ static std::string trimCopy(const std::string &input) {
   return input.substr(start, end - start + 1);
 }
 
+Lobby::Lobby(Game::Config conf) : game(conf) {
+  game.setStreetListener([this](GameStage stage) { onStreetDealt(stage); });
+}
+
+Lobby::~Lobby() { discardSpeculation(); }
+
 void Lobby::cleanupOrphanedSeats() {
   std::unordered_set<std::string> validUserIds;
   for (const auto &u : users) {
@@ -153,7 +167,11 @@ bool Lobby::rebuy(std::string id, int amount) {
 
 bool Lobby::handleGameAction(const std::string &userId,
                              const std::string &command, int amount) {
-  return game.playerAction(userId, command, amount);
+  bool ok = game.playerAction(userId, command, amount);
+  // A fold changes the live hands, so the speculated equities are useless
+  if (ok && command == "fold")
+    discardSpeculation();
+  return ok;
 }
 
 bool Lobby::handleMuckOrShow(const std::string &userId, bool show) {
@@ -194,6 +212,16 @@ bool Lobby::addChatMessage(const std::string &userId, const std::string &text) {
   return true;
 }
 
+bool Lobby::setHeroEquity(const std::string &userId, bool enabled) {
+  for (auto &u : users) {
+    if (u.id == userId) {
+      u.heroEquity = enabled;
+      return true;
+    }
+  }
+  return false;
+}
+
 // Host Actions
 
 bool Lobby::startGame(std::string hostId) {
@@ -208,6 +236,7 @@ bool Lobby::startGame(std::string hostId) {
     return false;
 
   gameInProgress = true;
+  discardSpeculation();
   game.startHand();
   return true;
 }
@@ -217,6 +246,7 @@ bool Lobby::endGame(std::string hostId) {
     return false;
 
   gameInProgress = false;
+  discardSpeculation();
   game.resetForEndGame();
   return true;
 }
@@ -238,6 +268,7 @@ bool Lobby::startNextHand(std::string hostId) {
     return false;
   }
 
+  discardSpeculation();
   game.startHand();
   return true;
 }
@@ -253,6 +284,7 @@ bool Lobby::updateConfig(std::string hostId, LobbyConfig newConfig) {
   gc.smallBlind = newConfig.smallBlind;
   gc.bigBlind = newConfig.bigBlind;
   gc.startingStack = newConfig.startingStack;
+  gc.shortDeck = newConfig.shortDeck;
   if (!game.applyConfig(gc)) {
     return false;
   }
@@ -367,7 +399,8 @@ bool Lobby::reconnectPlayer(const std::string &id) {
 nlohmann::json
 Lobby::toJsonForViewer(const std::string &viewerId,
                        bool includeEquities,
-                       const nlohmann::json *cachedEquities) const {
+                       const nlohmann::json *cachedEquities,
+                       const nlohmann::json *heroEquities) const {
   nlohmann::json state{
       {"lobbyConfig", lobbyConfig},
       {"users", users},
@@ -419,6 +452,23 @@ Lobby::toJsonForViewer(const std::string &viewerId,
     }
   }
 
+  // Seated players who asked for it see their own equity vs random hands
+  if (!viewerIsSpc) {
+    nlohmann::json computed;
+    if (!heroEquities && includeEquities) {
+      EquityRequest request = equityRequest();
+      bool wanted = std::any_of(
+          request.heroes.begin(), request.heroes.end(),
+          [&](const HeroSpot &h) { return h.userId == viewerId; });
+      if (wanted) {
+        computed = computeHeroEquities(request);
+        heroEquities = &computed;
+      }
+    }
+    if (heroEquities && heroEquities->contains(viewerId))
+      state["heroEquity"] = (*heroEquities)[viewerId];
+  }
+
   // Non-god-mode spectators see no hole cards at all
   if (viewerIsSpc && !atShowdown) {
     for (auto &seat : seats) {
@@ -445,7 +495,8 @@ void to_json(nlohmann::json &j, const LobbyConfig &c) {
                      {"smallBlind", c.smallBlind},
                      {"bigBlind", c.bigBlind},
                      {"actionTimeout", c.actionTimeout},
-                     {"godMode", c.godMode}};
+                     {"godMode", c.godMode},
+                     {"shortDeck", c.shortDeck}};
 }
 
 void to_json(nlohmann::json &j, const User &u) {
@@ -453,7 +504,8 @@ void to_json(nlohmann::json &j, const User &u) {
                      {"name", u.name},
                      {"isSpectator", u.isSpectator},
                      {"isHost", u.isHost},
-                     {"isConnected", u.isConnected}};
+                     {"isConnected", u.isConnected},
+                     {"heroEquity", u.heroEquity}};
 }
 
 void to_json(nlohmann::json &j, const ChatMessage &m) {
@@ -474,8 +526,11 @@ void to_json(nlohmann::json &j, const Lobby &l) {
 }
 
 nlohmann::json Lobby::computeEquities() const {
-  std::vector<std::vector<Card>> hands;
-  std::vector<int> handSeatIndices;
+  return computeEquities(equityRequest());
+}
+
+EquityRequest Lobby::equityRequest() const {
+  EquityRequest request;
   const auto &gameSeats = game.getSeats();
 
   for (int i = 0; i < static_cast<int>(gameSeats.size()); i++) {
@@ -483,17 +538,319 @@ nlohmann::json Lobby::computeEquities() const {
     if (p.hand.size() == 2 && p.status != PlayerStatus::Folded &&
         p.status != PlayerStatus::SittingOut &&
         p.status != PlayerStatus::Waiting) {
-      hands.push_back(p.hand);
-      handSeatIndices.push_back(i);
+      request.hands.push_back(p.hand);
+      request.seatIndices.push_back(i);
+    } else if (p.status == PlayerStatus::Folded) {
+      request.dead.insert(request.dead.end(), p.hand.begin(), p.hand.end());
     }
   }
+  request.board = game.getBoard();
+  const auto &burned = game.getBurnedCards();
+  request.dead.insert(request.dead.end(), burned.begin(), burned.end());
+  request.shortDeck = lobbyConfig.shortDeck;
+  request.speculation = dealtSpeculation;
+
+  // Only the hero's own cards and the board are known to them
+  // (random hands are full-deck ranges, so not in short deck)
+  int opponents = static_cast<int>(request.hands.size()) - 1;
+  if (opponents >= 1 && !request.shortDeck) {
+    for (int seat : request.seatIndices) {
+      const auto &p = gameSeats[seat];
+      bool optedIn = std::any_of(users.begin(), users.end(), [&](const User &u) {
+        return u.id == p.id && u.heroEquity && !u.isSpectator;
+      });
+      if (optedIn)
+        request.heroes.push_back({p.id, p.hand, opponents});
+    }
+  }
+  return request;
+}
+
+void Lobby::onStreetDealt(GameStage stage) {
+  // Last street's speculation covers the card just dealt
+  if (dealtSpeculation)
+    dealtSpeculation->cancel = true;
+  dealtSpeculation = std::move(speculation);
+  speculation.reset();
+
+  // Only the river needs one: on the flop and turn computeOuts already
+  // walks every next card (and its result is cached)
+  if (stage != GameStage::Turn) {
+    if (stage != GameStage::Flop && stage != GameStage::River)
+      discardSpeculation(); // hand is over
+    return;
+  }
 
+  EquityRequest request = equityRequest();
+  if (request.hands.size() < 2)
+    return;
+
+  auto spec = std::make_shared<EquitySpeculation>();
+  spec->hands = request.hands;
+  spec->board = request.board;
+  spec->dead = request.dead;
+  spec->shortDeck = request.shortDeck;
+  Card burn;
+  if (game.peekNextBurn(burn))
+    spec->dead.push_back(burn);
+  speculation = spec;
+
+  // Players think for seconds, every next card takes a few milliseconds
+  ThreadPool::instance().submit([spec] {
+    EquityOptions options;
+    options.cancel = &spec->cancel;
+    options.deadCards = spec->dead;
+    options.shortDeck = spec->shortDeck;
+    try {
+      spec->nextCard = EquityCalculator::calculateNextCard(
+          spec->hands, spec->board, options);
+    } catch (const std::exception &) {
+      return;
+    }
+    if (!spec->cancel)
+      spec->ready.store(true, std::memory_order_release);
+  });
+}
+
+void Lobby::discardSpeculation() {
+  for (auto *spec : {&speculation, &dealtSpeculation}) {
+    if (*spec) {
+      (*spec)->cancel = true;
+      spec->reset();
+    }
+  }
+}
+
+// Result worked out on the previous street for the card just dealt,
+// or nullptr if there is none (yet)
+static const EquityResult *speculatedResult(const EquityRequest &request) {
+  const auto &spec = request.speculation;
+  if (!spec || !spec->ready.load(std::memory_order_acquire))
+    return nullptr;
+  if (spec->hands != request.hands || spec->shortDeck != request.shortDeck ||
+      CardSet::fromCards(spec->dead) != CardSet::fromCards(request.dead) ||
+      request.board.size() != spec->board.size() + 1 ||
+      !std::equal(spec->board.begin(), spec->board.end(),
+                  request.board.begin()))
+    return nullptr;
+
+  const Card &next = request.board.back();
+  const EquityResult &result = spec->nextCard[next.rank() * 4 + next.suit()];
+  return result.equities.empty() ? nullptr : &result;
+}
+
+// Seat index -> equity, the format the frontend expects
+static nlohmann::json toEquityMap(const std::vector<int> &seatIndices,
+                                  const EquityResult &result) {
   nlohmann::json equityMap = nlohmann::json::object();
-  if (hands.size() >= 2) {
-    auto equities = EquityCalculator::calculateEquity(hands, game.getBoard());
-    for (size_t i = 0; i < handSeatIndices.size(); i++) {
-      equityMap[std::to_string(handSeatIndices[i])] = equities[i];
+  for (size_t i = 0; i < seatIndices.size(); i++) {
+    equityMap[std::to_string(seatIndices[i])] = result.equities[i];
+  }
+  return equityMap;
+}
+
+// Seat index -> {win, tie, categories: {name: frequency}}
+static nlohmann::json toBreakdownMap(const std::vector<int> &seatIndices,
+                                     const EquityResult &result) {
+  nlohmann::json breakdown = nlohmann::json::object();
+  if (result.winRates.size() != seatIndices.size())
+    return breakdown;
+  for (size_t i = 0; i < seatIndices.size(); i++) {
+    nlohmann::json categories = nlohmann::json::object();
+    for (int c = 0; c < NUM_HAND_CATEGORIES; c++) {
+      if (result.categories[i][c] > 0.0)
+        categories[Evaluator::categoryName(static_cast<HandCategory>(c))] =
+            result.categories[i][c];
     }
+    breakdown[std::to_string(seatIndices[i])] = {
+        {"win", result.winRates[i]},
+        {"tie", result.tieRates[i]},
+        {"categories", categories}};
+  }
+  return breakdown;
+}
+
+nlohmann::json Lobby::computeEquities(
+    const EquityRequest &request, const std::atomic<bool> *cancel,
+    const std::function<void(const nlohmann::json &)> &onProgress,
+    nlohmann::json *breakdown, double budgetScale, double *precision) {
+  if (breakdown)
+    *breakdown = nlohmann::json::object();
+  if (precision)
+    *precision = -1.0;
+  if (request.hands.size() < 2)
+    return nlohmann::json::object();
+
+  if (const EquityResult *known = speculatedResult(request)) {
+    if (breakdown)
+      *breakdown = toBreakdownMap(request.seatIndices, *known);
+    if (precision)
+      *precision = 0.0;
+    return toEquityMap(request.seatIndices, *known);
+  }
+
+  // +/- 0.5% is plenty for the display, so preflop stops sampling early
+  // Cached: most broadcasts (checks, calls, chat) repeat the last spot
+  EquityOptions options;
+  options.targetPrecision = 0.005;
+  options.deadCards = request.dead;
+  options.shortDeck = request.shortDeck;
+  options.cancel = cancel;
+  EquityBudget{budgetScale}.apply(options);
+  if (onProgress) {
+    options.onProgress = [&](const EquityResult &partial) {
+      onProgress(toEquityMap(request.seatIndices, partial));
+    };
+  }
+
+  auto result =
+      EquityCache::instance().calculate(request.hands, request.board, options);
+  if (result.cancelled)
+    return nlohmann::json::object();
+  if (breakdown)
+    *breakdown = toBreakdownMap(request.seatIndices, result);
+  if (precision)
+    *precision = achievedPrecision(result);
+  return toEquityMap(request.seatIndices, result);
+}
+
+// Outs reports by exact spot: every broadcast on a street (checks, bets,
+// chat) asks for the same one
+static std::mutex outsMtx;
+static LruCache<std::string, OutsReport> outsCache(256);
+
+static std::string outsKey(const EquityRequest &request) {
+  std::string key = request.shortDeck ? "S" : "F";
+  for (const auto &hand : request.hands)
+    key += std::to_string(CardSet::fromCards(hand).raw()) + ",";
+  key += "|" + std::to_string(CardSet::fromCards(request.board).raw()) + "|" +
+         std::to_string(CardSet::fromCards(request.dead).raw());
+  return key;
+}
+
+nlohmann::json Lobby::computeOuts(const EquityRequest &request,
+                                  const std::atomic<bool> *cancel,
+                                  nlohmann::json *equities,
+                                  nlohmann::json *breakdown) {
+  if (request.hands.size() < 2 ||
+      (request.board.size() != 3 && request.board.size() != 4))
+    return nlohmann::json::object();
+
+  std::string key = outsKey(request);
+  OutsReport report;
+  bool cached;
+  {
+    std::lock_guard<std::mutex> lock(outsMtx);
+    cached = outsCache.get(key, report);
+  }
+  if (!cached) {
+    // Same dead cards as the equities, so the two always agree
+    EquityOptions options;
+    options.deadCards = request.dead;
+    options.shortDeck = request.shortDeck;
+    options.cancel = cancel;
+    report = OutsAnalyzer::analyze(request.hands, request.board, options);
+    if (report.cancelled)
+      return nlohmann::json::object();
+    std::lock_guard<std::mutex> lock(outsMtx);
+    outsCache.put(key, report);
+  }
+  if (equities)
+    *equities = toEquityMap(request.seatIndices, report.current);
+  if (breakdown)
+    *breakdown = toBreakdownMap(request.seatIndices, report.current);
+
+  nlohmann::json cards = nlohmann::json::object();
+  for (int idx = 0; idx < 52; idx++) {
+    if (!report.byCard[idx].equities.empty())
+      cards[Card(idx / 4, idx % 4).toString()] =
+          toEquityMap(request.seatIndices, report.byCard[idx]);
+  }
+  nlohmann::json outs = nlohmann::json::object();
+  for (size_t i = 0; i < request.seatIndices.size(); i++)
+    outs[std::to_string(request.seatIndices[i])] = report.outs[i];
+  return {{"cards", cards}, {"outs", outs}};
+}
+
+bool Lobby::heatmapRequest(const std::string &viewerId, int seatIndex,
+                           HeatmapRequest &out) const {
+  const auto &gameSeats = game.getSeats();
+  if (seatIndex < 0 || seatIndex >= static_cast<int>(gameSeats.size()))
+    return false;
+  const auto &p = gameSeats[seatIndex];
+  if (p.hand.size() != 2 || p.id.empty())
+    return false;
+  if (lobbyConfig.shortDeck)
+    return false; // the 169 classes are full-deck hands
+
+  bool godView = isSpectator(viewerId) && lobbyConfig.godMode;
+  if (p.id != viewerId && !godView)
+    return false;
+
+  out.hand = p.hand;
+  out.board = game.getBoard();
+  out.dead.clear();
+  if (godView)
+    out.dead = equityRequest().dead;
+  return true;
+}
+
+nlohmann::json Lobby::computeHeatmap(const HeatmapRequest &request,
+                                     const std::atomic<bool> *cancel) {
+  EquityOptions options;
+  options.deadCards = request.dead;
+  options.cancel = cancel;
+  EquityHeatmap heatmap =
+      HeatmapCalculator::calculate(request.hand, request.board, options);
+  if (heatmap.cancelled)
+    return nlohmann::json::object();
+
+  nlohmann::json equity = nlohmann::json::array();
+  nlohmann::json combos = nlohmann::json::array();
+  for (int row = 0; row < 13; row++) {
+    nlohmann::json equityRow = nlohmann::json::array();
+    for (int col = 0; col < 13; col++) {
+      double e = heatmap.equity[row][col];
+      equityRow.push_back(e < 0 ? nlohmann::json() : nlohmann::json(e));
+    }
+    equity.push_back(equityRow);
+    combos.push_back(heatmap.combos[row]);
+  }
+  return {{"hand", request.hand},
+          {"board", request.board},
+          {"exact", heatmap.exact},
+          {"equity", equity},
+          {"combos", combos}};
+}
+
+nlohmann::json Lobby::computeHeroEquities(const EquityRequest &request,
+                                          const std::atomic<bool> *cancel,
+                                          double budgetScale) {
+  nlohmann::json equityMap = nlohmann::json::object();
+  if (request.heroes.empty())
+    return equityMap;
+
+  std::vector<std::vector<Card>> hands;
+  std::vector<int> opponents;
+  for (const auto &hero : request.heroes) {
+    hands.push_back(hero.hand);
+    opponents.push_back(hero.opponents);
+  }
+
+  // Same precision as the god-mode numbers; players sharing a spot (or
+  // repeating the last one) cost a single lookup. No dead cards: a player
+  // has not seen the folded hands or the burns.
+  EquityOptions options;
+  options.targetPrecision = 0.005;
+  options.cancel = cancel;
+  EquityBudget{budgetScale}.apply(options);
+  auto results = EquityCache::instance().calculateVsRandom(
+      hands, request.board, opponents, options);
+
+  for (size_t i = 0; i < results.size(); i++) {
+    if (results[i].cancelled)
+      return nlohmann::json::object();
+    equityMap[request.heroes[i].userId] = results[i].equities[0];
   }
   return equityMap;
 }
@@ -1,5 +1,9 @@
 #pragma once
 #include "../engine/Game.h"
+#include "../poker/EquityCalculator.h"
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -13,6 +17,7 @@ struct LobbyConfig {
   int bigBlind = 10;
   int actionTimeout = 0; // infinite
   bool godMode = true;   // Spectators see all cards + live equity
+  bool shortDeck = false; // 6+ Hold'em
 };
 
 struct User {
@@ -21,6 +26,7 @@ struct User {
   bool isSpectator = true;
   bool isHost = false;
   bool isConnected = true;
+  bool heroEquity = false; // wants own equity vs random hands
 };
 
 struct ChatMessage {
@@ -31,10 +37,57 @@ struct ChatMessage {
   long long timestamp = 0;
 };
 
+// Equity for every possible river, computed in the background while the
+// players bet on the turn
+struct EquitySpeculation {
+  std::vector<std::vector<Card>> hands;
+  std::vector<Card> board;
+  std::vector<Card> dead; // includes the burn before the next card
+  bool shortDeck = false;
+  std::vector<EquityResult> nextCard; // by card index, valid once ready
+  std::atomic<bool> cancel{false};
+  std::atomic<bool> ready{false};
+};
+
+// A seated player's own hand against random hands: all they know
+struct HeroSpot {
+  std::string userId;
+  std::vector<Card> hand;
+  int opponents = 0;
+};
+
+// Everything live equity needs, copied out of the lobby so the
+// simulation can run on another thread
+struct EquityRequest {
+  std::vector<std::vector<Card>> hands;
+  std::vector<int> seatIndices;
+  std::vector<Card> board;
+  // Folded hands and burned cards: out of play, though only god mode
+  // may know it
+  std::vector<Card> dead;
+  bool shortDeck = false;
+  // Previous street's speculation (may already hold the answer)
+  std::shared_ptr<const EquitySpeculation> speculation;
+  // Opted-in players still in the hand
+  std::vector<HeroSpot> heroes;
+};
+
+// One hand against all 169 starting-hand classes on the current board
+struct HeatmapRequest {
+  std::vector<Card> hand;
+  std::vector<Card> board;
+  std::vector<Card> dead;
+};
+
 // Manages table setup, user roles, and game lifecycle.
 class Lobby {
 public:
-  Lobby(Game::Config conf = Game::Config()) : game(conf) {}
+  Lobby(Game::Config conf = Game::Config());
+  ~Lobby();
+
+  // The game reports new streets back to this lobby
+  Lobby(const Lobby &) = delete;
+  Lobby &operator=(const Lobby &) = delete;
 
   // User management
   bool join(std::string id, std::string name);
@@ -48,6 +101,7 @@ public:
                         int amount);
   bool handleMuckOrShow(const std::string &userId, bool show);
   bool addChatMessage(const std::string &userId, const std::string &text);
+  bool setHeroEquity(const std::string &userId, bool enabled);
 
   // Host actions
   bool startGame(std::string hostId);
@@ -76,16 +130,65 @@ public:
   bool reconnectPlayer(const std::string &id);
 
   // Per-viewer serialisation (handles card masking & spectator view equities)
+  // heroEquities: userId -> equity from computeHeroEquities
   nlohmann::json
   toJsonForViewer(const std::string &viewerId,
                   bool includeEquities = true,
-                  const nlohmann::json *cachedEquities = nullptr) const;
+                  const nlohmann::json *cachedEquities = nullptr,
+                  const nlohmann::json *heroEquities = nullptr) const;
   nlohmann::json computeEquities() const;
 
+  // Async equity: snapshot on the owning thread, compute anywhere
+  // Setting cancel abandons the job (returns an empty map)
+  // onProgress gets coarse maps while sampling (preflop), the returned map
+  // is the final one
+  // breakdown (optional): seat index -> {win, tie, categories}, from the
+  // same pass (left empty when the preflop table answers)
+  // budgetScale: share of the sampling budget (EquityBudget), precision
+  // (optional): the 95% half-width reached, negative when cancelled
+  EquityRequest equityRequest() const;
+  static nlohmann::json computeEquities(
+      const EquityRequest &request, const std::atomic<bool> *cancel = nullptr,
+      const std::function<void(const nlohmann::json &)> &onProgress = nullptr,
+      nlohmann::json *breakdown = nullptr, double budgetScale = 1.0,
+      double *precision = nullptr);
+  // Flop / turn: equity after every possible next card and each
+  // player's outs ({"cards": {card: {seat: equity}}, "outs": {seat:
+  // [cards]}}), empty on other streets or when cancelled
+  // equities / breakdown (optional): the current ones, as computeEquities
+  // gives them, from the same pass over the runouts
+  // Cached by spot, so repeat broadcasts on a street are a lookup
+  static nlohmann::json computeOuts(const EquityRequest &request,
+                                    const std::atomic<bool> *cancel = nullptr,
+                                    nlohmann::json *equities = nullptr,
+                                    nlohmann::json *breakdown = nullptr);
+  // A seat's hand for a heatmap: the viewer's own seat, or any live seat
+  // for god-mode spectators (who also know folded hands and burns)
+  // False if there is no such hand or the viewer may not see it
+  bool heatmapRequest(const std::string &viewerId, int seatIndex,
+                      HeatmapRequest &out) const;
+  // {"hand", "board", "exact", "equity": 13x13 (null = no combo left),
+  //  "combos": 13x13}, grid as in EquityHeatmap; empty when cancelled
+  static nlohmann::json computeHeatmap(const HeatmapRequest &request,
+                                       const std::atomic<bool> *cancel = nullptr);
+  // userId -> equity vs random hands, every hero in one batch
+  static nlohmann::json
+  computeHeroEquities(const EquityRequest &request,
+                      const std::atomic<bool> *cancel = nullptr,
+                      double budgetScale = 1.0);
+
   friend void to_json(nlohmann::json &j, const Lobby &l);
 
 private:
   void cleanupOrphanedSeats();
+
+  // River speculation: started when the turn is dealt (computeOuts
+  // covers the turn itself), dropped when someone folds or the hand ends
+  void onStreetDealt(GameStage stage);
+  void discardSpeculation();
+  std::shared_ptr<EquitySpeculation> speculation;      // for the next card
+  std::shared_ptr<EquitySpeculation> dealtSpeculation; // covers the board
+
   Game game;
   std::vector<User> users;
   std::vector<ChatMessage> chatMessages;
@@ -1,9 +1,17 @@
+#include "../src/poker/BoardRankTable.h"
 #include "../src/poker/Card.h"
+#include "../src/poker/CardSet.h"
 #include "../src/poker/Deck.h"
 #include "../src/poker/Evaluator.h"
+#include "../src/poker/EvaluatorConstants.h"
+#include "../src/poker/ShortDeckEvaluator.h"
+#include "LegacyEvaluatorTables.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -133,7 +141,396 @@ void testEvaluator() {
   std::cout << "\nAll Evaluator Tests PASSED!" << std::endl;
 }
 
+// Best of the 21 five-card subsets (the old 6/7 card path)
+int bruteForceRank(const std::vector<Card> &cards) {
+  int best = 9999;
+  int n = cards.size();
+  for (int i = 0; i < n - 4; i++)
+    for (int j = i + 1; j < n - 3; j++)
+      for (int k = j + 1; k < n - 2; k++)
+        for (int l = k + 1; l < n - 1; l++)
+          for (int m = l + 1; m < n; m++)
+            best = std::min(best, Evaluator::evaluate(std::vector<Card>{
+                                      cards[i], cards[j], cards[k], cards[l],
+                                      cards[m]}));
+  return best;
+}
+
+void testDirectEvaluator() {
+  std::cout << "\n--- TESTING THE 6/7 CARD EVALUATOR ---\n" << std::endl;
+
+  // Flush with 6 suited cards + a pair on the side (best flush wins)
+  std::vector<Card> sixFlush = {Card(Card::RANK_A, Card::SUIT_CLUBS),
+                                Card(Card::RANK_J, Card::SUIT_CLUBS),
+                                Card(Card::RANK_9, Card::SUIT_CLUBS),
+                                Card(Card::RANK_8, Card::SUIT_CLUBS),
+                                Card(Card::RANK_4, Card::SUIT_CLUBS),
+                                Card(Card::RANK_2, Card::SUIT_CLUBS),
+                                Card(Card::RANK_2, Card::SUIT_HEARTS)};
+  assert_exact_rank("6-Suited Flush (AJ984)", Evaluator::evaluate(sixFlush),
+                    bruteForceRank(sixFlush));
+
+  // Two trips -> Full house (AAA KK)
+  std::vector<Card> twoTrips = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                                Card(Card::RANK_A, Card::SUIT_DIAMONDS),
+                                Card(Card::RANK_A, Card::SUIT_CLUBS),
+                                Card(Card::RANK_K, Card::SUIT_SPADES),
+                                Card(Card::RANK_K, Card::SUIT_HEARTS),
+                                Card(Card::RANK_K, Card::SUIT_CLUBS),
+                                Card(Card::RANK_2, Card::SUIT_HEARTS)};
+  assert_exact_rank("Two Trips (AAA KK)", Evaluator::evaluate(twoTrips), 167);
+
+  // Random 6 and 7 card hands must match the 21-combination loop
+  std::mt19937 rng(2024);
+  Deck deck;
+  for (int i = 0; i < 20000; i++) {
+    deck.shuffle(rng);
+    int n = (i % 2 == 0) ? 7 : 6;
+    std::vector<Card> hand;
+    for (int c = 0; c < n; c++)
+      hand.push_back(deck.deal());
+
+    int expected = bruteForceRank(hand);
+    if (Evaluator::evaluate(hand) != expected ||
+        Evaluator::evaluate(CardSet::fromCards(hand)) != expected) {
+      std::cout << "[FAIL] Random " << n << "-card hand mismatch" << std::endl;
+      std::exit(1);
+    }
+  }
+  std::cout << "[PASS] 20000 random 6/7-card hands match brute force"
+            << std::endl;
+}
+
+void testCardSet() {
+  std::cout << "\n--- TESTING CARDSET ---\n" << std::endl;
+
+  CardSet set;
+  set.add(Card(Card::RANK_A, Card::SUIT_SPADES));
+  set.add(Card(Card::RANK_2, Card::SUIT_CLUBS));
+  set.add(Card(Card::RANK_2, Card::SUIT_CLUBS)); // duplicate is a no-op
+  assert(set.size() == 2);
+  assert(set.contains(Card(Card::RANK_A, Card::SUIT_SPADES)));
+  assert(set.suitMask(Card::SUIT_SPADES) == (1u << Card::RANK_A));
+
+  CardSet other = CardSet::fromCards({Card(Card::RANK_K, Card::SUIT_HEARTS)});
+  assert((set | other).size() == 3);
+  assert(((set | other) - set) == other);
+  assert(CardSet::fullDeck().size() == 52);
+
+  // Iteration visits every card once, lowest bit first
+  std::vector<Card> seen;
+  for (Card c : set | other)
+    seen.push_back(c);
+  assert(seen.size() == 3);
+  assert(seen[0] == Card(Card::RANK_2, Card::SUIT_CLUBS));
+
+  // Array overload agrees with the vector one
+  std::array<Card, 7> seven = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                               Card(Card::RANK_K, Card::SUIT_HEARTS),
+                               Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                               Card(Card::RANK_J, Card::SUIT_HEARTS),
+                               Card(Card::RANK_T, Card::SUIT_HEARTS),
+                               Card(Card::RANK_2, Card::SUIT_SPADES),
+                               Card(Card::RANK_3, Card::SUIT_SPADES)};
+  assert_exact_rank("std::array 7-Card Royal", Evaluator::evaluate(seven), 1);
+
+  std::cout << "[PASS] CardSet basics" << std::endl;
+}
+
+void testBatchEvaluator() {
+  std::cout << "\n--- TESTING THE BATCH EVALUATOR ---\n" << std::endl;
+
+  // 5, 6 and 7 card hands; 1003 is not a multiple of the SIMD width
+  std::mt19937 rng(7);
+  Deck deck;
+  std::vector<CardSet> hands;
+  for (int i = 0; i < 1003; i++) {
+    deck.shuffle(rng);
+    CardSet hand;
+    for (int c = 0; c < 5 + i % 3; c++)
+      hand.add(deck.deal());
+    hands.push_back(hand);
+  }
+
+  std::vector<int> ranks(hands.size());
+  Evaluator::evaluateBatch(hands.data(), hands.size(), ranks.data());
+  for (size_t i = 0; i < hands.size(); i++) {
+    if (ranks[i] != Evaluator::evaluate(hands[i])) {
+      std::cout << "[FAIL] Batch rank mismatch at hand " << i << std::endl;
+      std::exit(1);
+    }
+  }
+  std::cout << "[PASS] Batch ranks match scalar ranks" << std::endl;
+}
+
+void testBoardRankTable() {
+  std::cout << "\n--- TESTING THE BOARD RANK TABLE ---\n" << std::endl;
+
+  // Combo index round trip
+  for (int combo = 0; combo < BoardRankTable::NUM_COMBOS; combo++) {
+    Card a, b;
+    BoardRankTable::comboCards(combo, a, b);
+    assert(a != b);
+    assert(BoardRankTable::comboIndex(a, b) == combo);
+    assert(BoardRankTable::comboIndex(b, a) == combo);
+  }
+
+  // Every live combo must match the evaluator on random boards
+  // (includes flush boards and paired boards)
+  std::mt19937 rng(11);
+  Deck deck;
+  for (int t = 0; t < 200; t++) {
+    deck.shuffle(rng);
+    std::vector<Card> board;
+    for (int c = 0; c < 5; c++)
+      board.push_back(deck.deal());
+
+    BoardRankTable table(board);
+    CardSet boardSet = CardSet::fromCards(board);
+    int live = 0;
+    for (int combo = 0; combo < BoardRankTable::NUM_COMBOS; combo++) {
+      Card a, b;
+      BoardRankTable::comboCards(combo, a, b);
+      if (boardSet.contains(a) || boardSet.contains(b)) {
+        assert(table.rank(combo) == 0);
+        continue;
+      }
+      live++;
+      std::vector<Card> seven = board;
+      seven.push_back(a);
+      seven.push_back(b);
+      if (table.rank(combo) != Evaluator::evaluate(seven)) {
+        std::cout << "[FAIL] Board table mismatch" << std::endl;
+        std::exit(1);
+      }
+    }
+    assert(live == 1081);
+  }
+  std::cout << "[PASS] Board rank table matches evaluator" << std::endl;
+}
+
+// Omaha the slow way: every 2 hole x 3 board subset
+static int bruteForceOmaha(const std::vector<Card> &hole,
+                           const std::vector<Card> &board) {
+  int best = 9999;
+  int n = board.size();
+  for (int i = 0; i < 4; i++)
+    for (int j = i + 1; j < 4; j++)
+      for (int a = 0; a < n; a++)
+        for (int b = a + 1; b < n; b++)
+          for (int c = b + 1; c < n; c++)
+            best = std::min(best, Evaluator::evaluate(std::vector<Card>{
+                                      hole[i], hole[j], board[a], board[b],
+                                      board[c]}));
+  return best;
+}
+
+void testOmahaEvaluator() {
+  std::cout << "\n--- TESTING THE OMAHA EVALUATOR ---\n" << std::endl;
+
+  // One heart in the hand: four on the board make no flush in Omaha
+  std::vector<Card> hole = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                            Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_K, Card::SUIT_DIAMONDS),
+                            Card(Card::RANK_Q, Card::SUIT_CLUBS)};
+  std::vector<Card> board = {Card(Card::RANK_K, Card::SUIT_HEARTS),
+                             Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                             Card(Card::RANK_J, Card::SUIT_HEARTS),
+                             Card(Card::RANK_T, Card::SUIT_HEARTS),
+                             Card(Card::RANK_2, Card::SUIT_CLUBS)};
+  std::vector<Card> nine = hole;
+  nine.insert(nine.end(), board.begin(), board.end());
+  assert_exact_rank("Any 5 of 9 (wrong for Omaha)", Evaluator::evaluate(nine),
+                    1);
+  assert_exact_rank("Omaha: Broadway, no flush",
+                    Evaluator::evaluateOmaha(hole, board), 1600);
+
+  // Random flops, turns and rivers match the brute force
+  std::mt19937 rng(23);
+  Deck deck;
+  for (int t = 0; t < 3000; t++) {
+    deck.shuffle(rng);
+    std::vector<Card> h, b;
+    for (int c = 0; c < 4; c++)
+      h.push_back(deck.deal());
+    for (int c = 0; c < 3 + t % 3; c++)
+      b.push_back(deck.deal());
+    if (Evaluator::evaluateOmaha(h, b) != bruteForceOmaha(h, b)) {
+      std::cout << "[FAIL] Omaha mismatch" << std::endl;
+      std::exit(1);
+    }
+  }
+
+  bool threw = false;
+  try {
+    Evaluator::evaluateOmaha({hole[0], hole[1]}, board);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "[PASS] Omaha evaluator matches brute force" << std::endl;
+}
+
+void testShortDeckEvaluator() {
+  std::cout << "\n--- TESTING THE SHORT-DECK EVALUATOR ---\n" << std::endl;
+
+  Deck deck(true);
+  assert(deck.count() == 36);
+  Card top;
+  assert(deck.peek(top) && deck.deal() == top && deck.count() == 35);
+  deck = Deck(true);
+  std::vector<Card> cards = deck.getCards();
+  for (const auto &c : cards)
+    assert(ShortDeckEvaluator::inDeck(c));
+
+  // Every 5-card hand: ranks 1..1404, all used
+  std::vector<bool> seen(ShortDeckEvaluator::NUM_RANKS + 1, false);
+  int n = cards.size();
+  for (int a = 0; a < n; a++)
+    for (int b = a + 1; b < n; b++)
+      for (int c = b + 1; c < n; c++)
+        for (int d = c + 1; d < n; d++)
+          for (int e = d + 1; e < n; e++) {
+            int rank = ShortDeckEvaluator::evaluate(
+                std::vector<Card>{cards[a], cards[b], cards[c], cards[d],
+                                  cards[e]});
+            assert(rank >= 1 && rank <= ShortDeckEvaluator::NUM_RANKS);
+            seen[rank] = true;
+          }
+  for (int r = 1; r <= ShortDeckEvaluator::NUM_RANKS; r++)
+    assert(seen[r]);
+
+  // Flush beats a full house, the wheel is A-6-7-8-9
+  std::vector<Card> flush = {Card(Card::RANK_9, Card::SUIT_HEARTS),
+                             Card(Card::RANK_8, Card::SUIT_HEARTS),
+                             Card(Card::RANK_7, Card::SUIT_HEARTS),
+                             Card(Card::RANK_6, Card::SUIT_HEARTS),
+                             Card(Card::RANK_J, Card::SUIT_HEARTS)};
+  std::vector<Card> boat = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                            Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_A, Card::SUIT_CLUBS),
+                            Card(Card::RANK_K, Card::SUIT_HEARTS),
+                            Card(Card::RANK_K, Card::SUIT_SPADES)};
+  std::vector<Card> wheel = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                             Card(Card::RANK_6, Card::SUIT_SPADES),
+                             Card(Card::RANK_7, Card::SUIT_CLUBS),
+                             Card(Card::RANK_8, Card::SUIT_HEARTS),
+                             Card(Card::RANK_9, Card::SUIT_DIAMONDS)};
+  std::vector<Card> sixHigh = {Card(Card::RANK_T, Card::SUIT_HEARTS),
+                               Card(Card::RANK_6, Card::SUIT_SPADES),
+                               Card(Card::RANK_7, Card::SUIT_CLUBS),
+                               Card(Card::RANK_8, Card::SUIT_HEARTS),
+                               Card(Card::RANK_9, Card::SUIT_DIAMONDS)};
+  assert(ShortDeckEvaluator::evaluate(flush) <
+         ShortDeckEvaluator::evaluate(boat));
+  assert(ShortDeckEvaluator::category(ShortDeckEvaluator::evaluate(wheel)) ==
+         HandCategory::Straight);
+  assert(ShortDeckEvaluator::evaluate(wheel) ==
+         ShortDeckEvaluator::evaluate(sixHigh) + 1);
+
+  // 7 cards: the best 5 of them
+  std::mt19937 rng(24);
+  for (int t = 0; t < 3000; t++) {
+    deck.shuffle(rng);
+    std::vector<Card> seven;
+    for (int c = 0; c < 7; c++)
+      seven.push_back(deck.deal());
+    int best = 9999;
+    for (int skipA = 0; skipA < 7; skipA++)
+      for (int skipB = skipA + 1; skipB < 7; skipB++) {
+        std::vector<Card> five;
+        for (int c = 0; c < 7; c++) {
+          if (c != skipA && c != skipB)
+            five.push_back(seven[c]);
+        }
+        best = std::min(best, ShortDeckEvaluator::evaluate(five));
+      }
+    if (ShortDeckEvaluator::evaluate(seven) != best) {
+      std::cout << "[FAIL] Short-deck 7-card mismatch" << std::endl;
+      std::exit(1);
+    }
+  }
+
+  // Batch (AVX2 when available) matches the scalar lookups, 5-7 cards
+  Deck shortDeck(true);
+  std::vector<CardSet> hands;
+  for (int i = 0; i < 1003; i++) {
+    shortDeck.shuffle(rng);
+    CardSet hand;
+    for (int c = 0; c < 5 + i % 3; c++)
+      hand.add(shortDeck.deal());
+    hands.push_back(hand);
+  }
+  std::vector<int> ranks(hands.size());
+  ShortDeckEvaluator::evaluateBatch(hands.data(), hands.size(), ranks.data());
+  for (size_t i = 0; i < hands.size(); i++)
+    assert(ranks[i] == ShortDeckEvaluator::evaluate(hands[i]));
+
+  bool threw = false;
+  try {
+    std::vector<Card> low = wheel;
+    low[0] = Card(Card::RANK_5, Card::SUIT_HEARTS);
+    ShortDeckEvaluator::evaluate(low);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "[PASS] Short-deck evaluator ranks all 1404 hands" << std::endl;
+}
+
+void testGeneratedTables() {
+  std::cout << "\n--- TESTING THE GENERATED TABLES ---\n" << std::endl;
+
+  assert(reinterpret_cast<std::uintptr_t>(&evaluatorTables) % 64 == 0);
+  assert(reinterpret_cast<std::uintptr_t>(evaluatorTables.noFlush) % 64 == 0);
+
+  // Table by table: flushes and unique5 are indexed by 5-rank masks
+  for (unsigned mask = 0; mask < 8192; mask++) {
+    if (tablegen::bitCount(mask) != 5)
+      continue;
+    unsigned char counts[13] = {0};
+    for (int r = 0; r < 13; r++)
+      counts[r] = (mask >> r) & 1;
+    assert(Evaluator::evaluateFlush(mask) == legacy::legacyFlushes[mask]);
+    if (legacy::legacyUnique5[mask])
+      assert(Evaluator::evaluateRanks(counts, 5) ==
+             legacy::legacyUnique5[mask]);
+  }
+
+  // Every 5-card hand, which covers the hash tables too
+  Deck deck;
+  std::vector<Card> cards = deck.getCards();
+  long long hands = 0;
+  for (int a = 0; a < 52; a++)
+    for (int b = a + 1; b < 52; b++)
+      for (int c = b + 1; c < 52; c++)
+        for (int d = c + 1; d < 52; d++)
+          for (int e = d + 1; e < 52; e++) {
+            const Card five[5] = {cards[a], cards[b], cards[c], cards[d],
+                                  cards[e]};
+            if (Evaluator::evaluate(five, 5) !=
+                legacy::evaluate5(five[0], five[1], five[2], five[3],
+                                  five[4])) {
+              std::cout << "[FAIL] Generated tables differ from the legacy "
+                           "ones"
+                        << std::endl;
+              std::exit(1);
+            }
+            hands++;
+          }
+  assert(hands == 2598960);
+  std::cout << "[PASS] Generated tables match the legacy ones on all "
+            << hands << " hands" << std::endl;
+}
+
 int main() {
   testEvaluator();
+  testGeneratedTables();
+  testDirectEvaluator();
+  testCardSet();
+  testBatchEvaluator();
+  testBoardRankTable();
+  testOmahaEvaluator();
+  testShortDeckEvaluator();
   return 0;
 }
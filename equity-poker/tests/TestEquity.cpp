@@ -1,11 +1,30 @@
+#include "../src/poker/BoardRankTable.h"
 #include "../src/poker/Card.h"
 #include "../src/poker/Deck.h"
+#include "../src/poker/EquityCache.h"
 #include "../src/poker/EquityCalculator.h"
+#include "../src/poker/EquityHeatmap.h"
+#include "../src/poker/EquityScheduler.h"
 #include "../src/poker/Evaluator.h"
+#include "../src/poker/HandStrength.h"
+#include "../src/poker/LruCache.h"
+#include "../src/poker/OutsAnalyzer.h"
+#include "../src/poker/PreflopTable.h"
+#include "../src/poker/Random.h"
+#include "../src/poker/Range.h"
+#include "../src/poker/ShortDeckEvaluator.h"
+#include "../src/poker/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace poker;
@@ -62,7 +81,7 @@ void testEquity() {
                             Card(Card::RANK_2, Card::SUIT_DIAMONDS)};
 
   // Royal Flush Draw vs Top Two Pair
-  // (Standard deviation is small with 100k iters)
+  // (Flop is enumerated exactly)
   equities = EquityCalculator::calculateEquity({draw, topTwo}, flop);
   assert_equity("Flush Draw vs Top Two Pair", equities[0], 0.42, 0.02);
 
@@ -84,10 +103,939 @@ void testEquity() {
   equities = EquityCalculator::calculateEquity({junk1, junk2}, boardChop);
   assert_equity("Chop Pot (Royal on Board)", equities[0], 0.50, 0.01);
 
+  // 6. Turn is enumerated exactly
+  // Board: Ah Kh 7c 2d, P1: Qh Jh vs P2: As Ad (set)
+  // P1 wins with 3h 4h 5h 6h 8h 9h Th and Tc Td Ts -> 10 / 44 rivers
+  // (7h and 2h fill P2 up)
+  std::vector<Card> turn = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                            Card(Card::RANK_K, Card::SUIT_HEARTS),
+                            Card(Card::RANK_7, Card::SUIT_CLUBS),
+                            Card(Card::RANK_2, Card::SUIT_DIAMONDS)};
+  std::vector<Card> qjh = {Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                           Card(Card::RANK_J, Card::SUIT_HEARTS)};
+  std::vector<Card> aces = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_A, Card::SUIT_DIAMONDS)};
+  equities = EquityCalculator::calculateEquity({qjh, aces}, turn);
+  assert_equity("Exact Turn (10 outs)", equities[0], 10.0 / 44.0, 1e-9);
+
+  // 7. Flop enumeration gives the same answer every time
+  auto first = EquityCalculator::calculateEquity({draw, topTwo}, flop);
+  auto second = EquityCalculator::calculateEquity({draw, topTwo}, flop);
+  assert_equity("Exact Flop (repeatable)", first[0], second[0], 1e-12);
+
+  // 8. A fixed seed makes sampling reproducible (preflop is sampled)
+  EquityOptions seeded;
+  seeded.seed = 12345;
+  auto runA = EquityCalculator::calculateEquity({ak, aq}, board, seeded);
+  auto runB = EquityCalculator::calculateEquity({ak, aq}, board, seeded);
+  assert_equity("Seeded Preflop (repeatable)", runA[0], runB[0], 1e-15);
+  assert_equity("Seeded Preflop (AK vs AQ)", runA[0], 0.74);
+
+  // Chunk streams: the k-th nextStream() is the seed jumped k times
+  FastRng streams(12345), jumped(12345);
+  for (int k = 0; k < 3; k++) {
+    FastRng stream = streams.nextStream();
+    assert(stream.next() == FastRng(jumped).next());
+    jumped.jump();
+  }
+
+  // 9. Precision target: stops early, estimate close to the true equity
+  EquityOptions precise;
+  precise.seed = 777;
+  precise.targetPrecision = 0.01;
+  precise.maxIterations = 1000000;
+  precise.usePreflopTable = false;
+  EquityResult adaptive =
+      EquityCalculator::calculate({ak, aq}, board, precise);
+  assert(!adaptive.exact);
+  assert(adaptive.iterations < precise.maxIterations);
+  assert(1.96 * adaptive.stdErrors[0] <= 0.01);
+  EquityOptions enumerate;
+  enumerate.forceExact = true;
+  double truth = EquityCalculator::calculate({ak, aq}, board, enumerate)
+                     .equities[0];
+  // The 95% interval misses for one seed in 20; 4 standard errors holds
+  // for all but one in ~15000, so this does not depend on the seed
+  assert(std::abs(adaptive.equities[0] - truth) <= 4 * adaptive.stdErrors[0]);
+  std::cout << "[PASS] Adaptive Preflop: " << adaptive.iterations
+            << " iterations, CI [" << adaptive.ciLow[0] << ", "
+            << adaptive.ciHigh[0] << "]" << std::endl;
+
+  // Exact streets report zero error and the number of runouts
+  EquityResult turnResult = EquityCalculator::calculate({qjh, aces}, turn);
+  assert(turnResult.exact && turnResult.iterations == 44);
+  assert(turnResult.stdErrors[0] == 0.0);
+  assert(turnResult.ciLow[0] == turnResult.ciHigh[0]);
+  std::cout << "[PASS] Exact Turn (44 runouts, no error)" << std::endl;
+
+  // 10. Progress: coarse estimate after the first 4096 iterations, then
+  // growing rounds; the final result is only the return value
+  std::vector<long long> steps;
+  EquityOptions streamed;
+  streamed.seed = 99;
+  streamed.usePreflopTable = false;
+  streamed.onProgress = [&](const EquityResult &partial) {
+    assert(!partial.exact && partial.equities.size() == 2);
+    steps.push_back(partial.iterations);
+  };
+  EquityResult streamedFinal =
+      EquityCalculator::calculate({ak, aq}, board, streamed);
+  assert(!steps.empty() && steps.front() == 4096);
+  assert(std::is_sorted(steps.begin(), steps.end()));
+  assert(steps.back() < streamedFinal.iterations);
+  assert(streamedFinal.iterations == streamed.maxIterations);
+  std::cout << "[PASS] Progress (" << steps.size() << " updates)" << std::endl;
+
+  // 11. Cancelled jobs stop before doing any work
+  std::atomic<bool> cancel{true};
+  EquityOptions cancelled;
+  cancelled.cancel = &cancel;
+  cancelled.usePreflopTable = false;
+  EquityResult stopped = EquityCalculator::calculate({ak, aq}, board, cancelled);
+  assert(stopped.cancelled && stopped.iterations == 0);
+  assert(EquityCalculator::calculate({draw, topTwo}, flop, cancelled).cancelled);
+  std::cout << "[PASS] Cancelled (preflop + flop)" << std::endl;
+
+  // 12. Every next card in one pass matches dealing it and recomputing
+  auto nextTurn = EquityCalculator::calculateNextCard({draw, topTwo}, flop);
+  int live = 0;
+  for (int idx = 0; idx < 52; idx++) {
+    if (nextTurn[idx].equities.empty())
+      continue;
+    live++;
+    std::vector<Card> dealt = flop;
+    dealt.emplace_back(idx / 4, idx % 4);
+    auto direct = EquityCalculator::calculate({draw, topTwo}, dealt);
+    assert(nextTurn[idx].exact && nextTurn[idx].iterations == 44);
+    assert(std::abs(nextTurn[idx].equities[0] - direct.equities[0]) < 1e-9);
+  }
+  assert(live == 45);
+  auto nextRiver = EquityCalculator::calculateNextCard({qjh, aces}, turn);
+  int riverWins = 0;
+  for (const auto &r : nextRiver)
+    riverWins += !r.equities.empty() && r.equities[0] == 1.0;
+  assert(riverWins == 10);
+  std::cout << "[PASS] Next card (45 turns, 44 rivers)" << std::endl;
+
+  // 13. Dead cards: 3h 4h folded and Tc burned leave 7 outs in 41 rivers
+  EquityOptions deadOpts;
+  deadOpts.deadCards = {Card(Card::RANK_3, Card::SUIT_HEARTS),
+                        Card(Card::RANK_4, Card::SUIT_HEARTS),
+                        Card(Card::RANK_T, Card::SUIT_CLUBS)};
+  auto dead = EquityCalculator::calculate({qjh, aces}, turn, deadOpts);
+  assert(dead.exact && dead.iterations == 41);
+  assert_equity("Dead Cards (7 outs left)", dead.equities[0], 7.0 / 41.0,
+                1e-9);
+  auto deadNext = EquityCalculator::calculateNextCard({qjh, aces}, turn,
+                                                      deadOpts);
+  assert(deadNext[Card::RANK_3 * 4 + Card::SUIT_HEARTS].equities.empty());
+
+  // Preflop the table is skipped and the dead cards still count: AA vs KK
+  // with two more kings gone
+  EquityOptions deadPre;
+  deadPre.seed = 5;
+  deadPre.deadCards = {Card(Card::RANK_K, Card::SUIT_CLUBS),
+                       Card(Card::RANK_K, Card::SUIT_HEARTS)};
+  std::vector<Card> kings = {Card(Card::RANK_K, Card::SUIT_SPADES),
+                             Card(Card::RANK_K, Card::SUIT_DIAMONDS)};
+  std::vector<Card> acesCH = {Card(Card::RANK_A, Card::SUIT_CLUBS),
+                              Card(Card::RANK_A, Card::SUIT_HEARTS)};
+  double kkLive = EquityCalculator::calculate({kings, acesCH}, {}).equities[0];
+  double kkDead =
+      EquityCalculator::calculate({kings, acesCH}, {}, deadPre).equities[0];
+  assert(kkDead < kkLive - 0.02);
+  std::cout << "[PASS] Dead cards (turn exact, preflop sampled)" << std::endl;
+
+  // 14. Win / tie / category breakdown from the same pass
+  assert(Evaluator::category(1) == HandCategory::StraightFlush);
+  assert(Evaluator::category(1599) == HandCategory::Flush);
+  assert(Evaluator::category(1600) == HandCategory::Straight);
+  assert(Evaluator::category(7462) == HandCategory::HighCard);
+
+  // Qh Jh's 10 outs: Th royal, 8 more hearts, Tc Td Ts for the straight
+  auto turnStats = EquityCalculator::calculate({qjh, aces}, turn);
+  auto share = [&](int p, HandCategory c) {
+    return turnStats.categories[p][static_cast<int>(c)];
+  };
+  assert(std::abs(turnStats.winRates[0] - 10.0 / 44.0) < 1e-9);
+  assert(turnStats.tieRates[0] == 0.0 && turnStats.tieRates[1] == 0.0);
+  assert(std::abs(share(0, HandCategory::StraightFlush) - 1.0 / 44.0) < 1e-9);
+  assert(std::abs(share(0, HandCategory::Flush) - 8.0 / 44.0) < 1e-9);
+  assert(std::abs(share(0, HandCategory::Straight) - 3.0 / 44.0) < 1e-9);
+
+  auto chop = EquityCalculator::calculate({junk1, junk2}, boardChop);
+  assert(chop.tieRates[0] == 1.0 && chop.winRates[0] == 0.0);
+  assert(chop.categories[1][static_cast<int>(HandCategory::StraightFlush)] ==
+         1.0);
+
+  EquityOptions statsOpts;
+  statsOpts.seed = 9;
+  statsOpts.usePreflopTable = false;
+  auto preStats = EquityCalculator::calculate({kings, acesCH}, {}, statsOpts);
+  for (int p = 0; p < 2; p++) {
+    double total = 0.0;
+    for (double c : preStats.categories[p])
+      total += c;
+    assert(std::abs(total - 1.0) < 1e-9);
+    // equity = win + tie / 2 heads-up
+    assert(std::abs(preStats.winRates[p] + preStats.tieRates[p] / 2 -
+                    preStats.equities[p]) < 1e-9);
+  }
+  std::cout << "[PASS] Win / tie / hand categories" << std::endl;
+
+  // 15. Outs: Qh Jh's 10 rivers, nothing for the leader
+  OutsReport outs = OutsAnalyzer::analyze({qjh, aces}, turn);
+  assert(std::abs(outs.equities[0] - 10.0 / 44.0) < 1e-9);
+  assert(outs.outs[0].size() == 10 && outs.outs[1].empty());
+  assert(std::find(outs.outs[0].begin(), outs.outs[0].end(),
+                   Card(Card::RANK_T, Card::SUIT_CLUBS)) != outs.outs[0].end());
+  assert(outs.byCard[Card::RANK_A * 4 + Card::SUIT_HEARTS].equities.empty());
+
+  // Flop: current equity matches the full enumeration
+  std::vector<Card> flopOnly(turn.begin(), turn.begin() + 3);
+  OutsReport flopOuts = OutsAnalyzer::analyze({qjh, aces}, flopOnly);
+  auto flopExact = EquityCalculator::calculate({qjh, aces}, flopOnly);
+  assert(std::abs(flopOuts.equities[0] - flopExact.equities[0]) < 1e-9);
+  const EquityResult &now = flopOuts.current;
+  assert(now.exact && now.iterations == flopExact.iterations);
+  for (int p = 0; p < 2; p++) {
+    assert(std::abs(now.winRates[p] - flopExact.winRates[p]) < 1e-9);
+    assert(std::abs(now.tieRates[p] - flopExact.tieRates[p]) < 1e-9);
+    for (int c = 0; c < NUM_HAND_CATEGORIES; c++)
+      assert(std::abs(now.categories[p][c] - flopExact.categories[p][c]) <
+             1e-9);
+  }
+  assert(OutsAnalyzer::leader({0.5, 0.5}) == -1);
+  std::cout << "[PASS] Outs (10 on the turn, flop matches enumeration)"
+            << std::endl;
+
+  // No hands: an empty answer on every street
+  std::vector<Card> river = {Card(Card::RANK_2, Card::SUIT_HEARTS),
+                             Card(Card::RANK_7, Card::SUIT_CLUBS),
+                             Card(Card::RANK_9, Card::SUIT_SPADES),
+                             Card(Card::RANK_J, Card::SUIT_DIAMONDS),
+                             Card(Card::RANK_K, Card::SUIT_HEARTS)};
+  for (size_t n : {0, 3, 5}) {
+    std::vector<Card> b(river.begin(), river.begin() + n);
+    assert(EquityCalculator::calculateEquity({}, b).empty());
+  }
+  std::cout << "[PASS] No hands, no equities" << std::endl;
+
   std::cout << "\nAll Equity Tests PASSED!" << std::endl;
 }
 
+// Exact equity of hand vs every combo of a class, averaged
+static double classAverage(const std::vector<Card> &hand,
+                           const std::vector<Card> &board,
+                           const std::string &cls) {
+  Range range = Range::parse(cls);
+  range.removeCards(CardSet::fromCards(hand) | CardSet::fromCards(board));
+  double total = 0.0;
+  int n = 0;
+  for (int combo = 0; combo < Range::NUM_COMBOS; combo++) {
+    if (range.weight(combo) <= 0.0f)
+      continue;
+    Card a, b;
+    BoardRankTable::comboCards(combo, a, b);
+    total += EquityCalculator::calculate({hand, {a, b}}, board).equities[0];
+    n++;
+  }
+  return total / n;
+}
+
+void testHeatmap() {
+  std::cout << "\n--- TESTING EQUITY HEATMAP ---\n" << std::endl;
+
+  assert(HeatmapCalculator::className(0, 0) == "AA");
+  assert(HeatmapCalculator::className(0, 1) == "AKs");
+  assert(HeatmapCalculator::className(1, 0) == "AKo");
+  assert(HeatmapCalculator::className(12, 12) == "22");
+
+  std::vector<Card> hand = {Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                            Card(Card::RANK_J, Card::SUIT_HEARTS)};
+  std::vector<Card> flop = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                            Card(Card::RANK_K, Card::SUIT_HEARTS),
+                            Card(Card::RANK_7, Card::SUIT_CLUBS)};
+  std::vector<Card> turn = flop;
+  turn.push_back(Card(Card::RANK_2, Card::SUIT_DIAMONDS));
+
+  // Turn and flop are exact: each cell is the class average
+  auto turnMap = HeatmapCalculator::calculate(hand, turn);
+  assert(turnMap.exact && turnMap.iterations == 46);
+  assert(turnMap.combos[0][0] == 3 && turnMap.combos[1][0] == 6);
+  assert(std::abs(turnMap.equity[0][0] - classAverage(hand, turn, "AA")) <
+         1e-9);
+  assert(std::abs(turnMap.equity[4][4] - classAverage(hand, turn, "TT")) <
+         1e-9);
+  assert(std::abs(turnMap.equity[0][5] - classAverage(hand, turn, "A9s")) <
+         1e-9);
+
+  auto flopMap = HeatmapCalculator::calculate(hand, flop);
+  assert(flopMap.exact && flopMap.iterations == 1081);
+  assert(std::abs(flopMap.equity[1][0] - classAverage(hand, flop, "AKo")) <
+         1e-9);
+
+  // QJs: the hand itself is gone, the other three are left
+  assert(turnMap.combos[2][3] == 3);
+
+  // Preflop is sampled: AA vs KK ~ 82%
+  EquityOptions options;
+  options.seed = 4;
+  std::vector<Card> aces = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_A, Card::SUIT_DIAMONDS)};
+  auto preMap = HeatmapCalculator::calculate(aces, {}, options);
+  assert(!preMap.exact && preMap.iterations == 5000);
+  assert(std::abs(preMap.equity[1][1] - 0.82) < 0.02);
+  assert(preMap.combos[0][0] == 1);
+
+  bool threw = false;
+  try {
+    HeatmapCalculator::calculate(aces, {aces[0]});
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  assert(threw);
+
+  std::cout << "[PASS] Heatmap (exact turn / flop, sampled preflop)"
+            << std::endl;
+}
+
+// Turn HS^2 and PPOT the slow way: every river, every opponent combo
+static void bruteForceTurn(const std::vector<Card> &hand,
+                           const std::vector<Card> &turn, double &hs2,
+                           double &ppot) {
+  CardSet used = CardSet::fromCards(hand) | CardSet::fromCards(turn);
+  double sumSq = 0.0, up = 0.0, notAhead = 0.0;
+  int rivers = 0;
+  for (int r = 0; r < 52; r++) {
+    Card river(r / 4, r % 4);
+    if (used.contains(river))
+      continue;
+    std::vector<Card> board = turn;
+    board.push_back(river);
+    double ahead = 0.0, live = 0.0;
+    for (int combo = 0; combo < BoardRankTable::NUM_COMBOS; combo++) {
+      Card a, b;
+      BoardRankTable::comboCards(combo, a, b);
+      if (used.contains(a) || used.contains(b) || a == river || b == river)
+        continue;
+      std::vector<Card> mine = hand, theirs = {a, b};
+      mine.insert(mine.end(), turn.begin(), turn.end());
+      theirs.insert(theirs.end(), turn.begin(), turn.end());
+      int nowMine = Evaluator::evaluate(mine);
+      int nowTheirs = Evaluator::evaluate(theirs);
+      mine.push_back(river);
+      theirs.push_back(river);
+      int endMine = Evaluator::evaluate(mine);
+      int endTheirs = Evaluator::evaluate(theirs);
+      double end = endMine < endTheirs ? 1.0 : endMine == endTheirs ? 0.5 : 0.0;
+      ahead += end;
+      live++;
+      // Behind now counts fully, tied half (and only if it ends ahead)
+      if (nowMine > nowTheirs) {
+        notAhead += 1.0;
+        up += end;
+      } else if (nowMine == nowTheirs) {
+        notAhead += 0.5;
+        up += end == 1.0 ? 0.5 : 0.0;
+      }
+    }
+    sumSq += (ahead / live) * (ahead / live);
+    rivers++;
+  }
+  hs2 = sumSq / rivers;
+  ppot = up / notAhead;
+}
+
+void testHandStrength() {
+  std::cout << "\n--- TESTING HAND STRENGTH ---\n" << std::endl;
+
+  // River: the nuts, and a board everyone plays
+  std::vector<Card> royal = {Card(Card::RANK_J, Card::SUIT_SPADES),
+                             Card(Card::RANK_T, Card::SUIT_SPADES)};
+  std::vector<Card> river = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                             Card(Card::RANK_K, Card::SUIT_SPADES),
+                             Card(Card::RANK_Q, Card::SUIT_SPADES),
+                             Card(Card::RANK_2, Card::SUIT_DIAMONDS),
+                             Card(Card::RANK_3, Card::SUIT_CLUBS)};
+  HandStrength nuts = HandStrengthCalculator::calculate(royal, river);
+  assert(nuts.hs == 1.0 && nuts.hs2 == 1.0 && nuts.ehs == 1.0);
+  assert(nuts.ppot == 0.0 && nuts.npot == 0.0);
+  std::vector<Card> junk = {Card(Card::RANK_2, Card::SUIT_SPADES),
+                            Card(Card::RANK_3, Card::SUIT_SPADES)};
+  std::vector<Card> boardRoyal = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                                  Card(Card::RANK_K, Card::SUIT_HEARTS),
+                                  Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                                  Card(Card::RANK_J, Card::SUIT_HEARTS),
+                                  Card(Card::RANK_T, Card::SUIT_HEARTS)};
+  HandStrength chop = HandStrengthCalculator::calculate(junk, boardRoyal);
+  assert(chop.hs == 0.5 && chop.hs2 == 0.25);
+
+  // Turn agrees with the slow way
+  std::vector<Card> draw = {Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                            Card(Card::RANK_J, Card::SUIT_HEARTS)};
+  std::vector<Card> turn = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                            Card(Card::RANK_K, Card::SUIT_HEARTS),
+                            Card(Card::RANK_7, Card::SUIT_CLUBS),
+                            Card(Card::RANK_2, Card::SUIT_DIAMONDS)};
+  HandStrength turnHs = HandStrengthCalculator::calculate(draw, turn);
+  double hs2, ppot;
+  bruteForceTurn(draw, turn, hs2, ppot);
+  assert(std::abs(turnHs.hs2 - hs2) < 1e-12);
+  assert(std::abs(turnHs.ppot - ppot) < 1e-12);
+
+  // Flop: a big draw is mostly behind now but improves a lot
+  std::vector<Card> flop(turn.begin(), turn.begin() + 3);
+  HandStrengthCalculator::clearCache();
+  auto start = std::chrono::steady_clock::now();
+  HandStrength flopHs = HandStrengthCalculator::calculate(draw, flop);
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  assert(flopHs.ppot > 0.3 && flopHs.ehs > flopHs.hs);
+  assert(flopHs.hs2 > 0.0 && flopHs.hs2 < 1.0);
+
+  // Suit renaming: same spot, answered from the cache
+  std::vector<Card> drawIso = {Card(Card::RANK_Q, Card::SUIT_SPADES),
+                               Card(Card::RANK_J, Card::SUIT_SPADES)};
+  std::vector<Card> flopIso = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                               Card(Card::RANK_K, Card::SUIT_SPADES),
+                               Card(Card::RANK_7, Card::SUIT_DIAMONDS)};
+  HandStrength iso = HandStrengthCalculator::calculate(drawIso, flopIso);
+  assert(iso.hs2 == flopHs.hs2 && iso.ppot == flopHs.ppot);
+
+  bool threw = false;
+  try {
+    HandStrengthCalculator::calculate(draw, {});
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  assert(threw);
+
+  std::cout << "[PASS] Hand strength (HS " << flopHs.hs << ", HS2 "
+            << flopHs.hs2 << ", PPOT " << flopHs.ppot << ", NPOT "
+            << flopHs.npot << ", flop in " << ms << " ms)" << std::endl;
+}
+
+void testOmahaEquity() {
+  std::cout << "\n--- TESTING OMAHA EQUITY ---\n" << std::endl;
+
+  std::vector<Card> aces = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_A, Card::SUIT_HEARTS),
+                            Card(Card::RANK_K, Card::SUIT_SPADES),
+                            Card(Card::RANK_K, Card::SUIT_HEARTS)};
+  std::vector<Card> rundown = {Card(Card::RANK_9, Card::SUIT_DIAMONDS),
+                               Card(Card::RANK_8, Card::SUIT_DIAMONDS),
+                               Card(Card::RANK_7, Card::SUIT_CLUBS),
+                               Card(Card::RANK_6, Card::SUIT_CLUBS)};
+  std::vector<Card> flop = {Card(Card::RANK_T, Card::SUIT_DIAMONDS),
+                            Card(Card::RANK_5, Card::SUIT_CLUBS),
+                            Card(Card::RANK_2, Card::SUIT_SPADES)};
+
+  // Flop is exact: same as scoring every runout by hand
+  EquityResult result = EquityCalculator::calculate({aces, rundown}, flop);
+  assert(result.exact && result.iterations == 820);
+  CardSet used = CardSet::fromCards(aces) | CardSet::fromCards(rundown) |
+                 CardSet::fromCards(flop);
+  double share = 0.0;
+  int runouts = 0;
+  for (int t = 0; t < 52; t++) {
+    for (int r = t + 1; r < 52; r++) {
+      Card turn(t / 4, t % 4), river(r / 4, r % 4);
+      if (used.contains(turn) || used.contains(river))
+        continue;
+      std::vector<Card> board = flop;
+      board.push_back(turn);
+      board.push_back(river);
+      int mine = Evaluator::evaluateOmaha(aces, board);
+      int theirs = Evaluator::evaluateOmaha(rundown, board);
+      share += mine < theirs ? 1.0 : mine == theirs ? 0.5 : 0.0;
+      runouts++;
+    }
+  }
+  assert_equity("Omaha Flop (AAKK vs 9876 wrap)", result.equities[0],
+                share / runouts, 1e-12);
+
+  // Preflop is sampled, and never answered by the Hold'em table
+  EquityOptions options;
+  options.seed = 8;
+  EquityResult pre = EquityCalculator::calculate({aces, rundown}, {}, options);
+  assert(!pre.exact);
+  assert_equity("Omaha Preflop (AAKK ds vs 9876 ds)", pre.equities[0], 0.6,
+                0.1);
+
+  // River: a lone hand takes it all, no hands gives nothing
+  std::vector<Card> river = flop;
+  river.push_back(Card(Card::RANK_J, Card::SUIT_SPADES));
+  river.push_back(Card(Card::RANK_3, Card::SUIT_HEARTS));
+  assert(EquityCalculator::calculate({aces}, river).equities[0] == 1.0);
+  assert(EquityCalculator::calculate({}, river).equities.empty());
+
+  bool threw = false;
+  try {
+    EquityCalculator::calculate({aces, {rundown[0], rundown[1]}}, flop);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  assert(threw);
+
+  std::cout << "[PASS] Omaha river and bad hands" << std::endl;
+}
+
+void testShortDeckEquity() {
+  std::cout << "\n--- TESTING SHORT-DECK EQUITY ---\n" << std::endl;
+
+  std::vector<Card> aces = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_A, Card::SUIT_HEARTS)};
+  std::vector<Card> suited = {Card(Card::RANK_9, Card::SUIT_DIAMONDS),
+                              Card(Card::RANK_8, Card::SUIT_DIAMONDS)};
+  std::vector<Card> flop = {Card(Card::RANK_T, Card::SUIT_DIAMONDS),
+                            Card(Card::RANK_7, Card::SUIT_CLUBS),
+                            Card(Card::RANK_K, Card::SUIT_DIAMONDS)};
+
+  // Flop is exact over the 36-card deck
+  EquityOptions options;
+  options.shortDeck = true;
+  EquityResult result =
+      EquityCalculator::calculate({aces, suited}, flop, options);
+  assert(result.exact && result.iterations == 406);
+  CardSet used = CardSet::fromCards(aces) | CardSet::fromCards(suited) |
+                 CardSet::fromCards(flop);
+  double share = 0.0, flushes = 0.0;
+  int runouts = 0;
+  for (int t = 0; t < 52; t++) {
+    for (int r = t + 1; r < 52; r++) {
+      Card turn(t / 4, t % 4), river(r / 4, r % 4);
+      if (!ShortDeckEvaluator::inDeck(turn) ||
+          !ShortDeckEvaluator::inDeck(river) || used.contains(turn) ||
+          used.contains(river))
+        continue;
+      CardSet board =
+          CardSet::fromCards(flop) | CardSet::fromCards({turn, river});
+      int mine = ShortDeckEvaluator::evaluate(board | CardSet::fromCards(aces));
+      int theirs =
+          ShortDeckEvaluator::evaluate(board | CardSet::fromCards(suited));
+      share += mine < theirs ? 1.0 : mine == theirs ? 0.5 : 0.0;
+      flushes += ShortDeckEvaluator::category(theirs) == HandCategory::Flush;
+      runouts++;
+    }
+  }
+  assert_equity("Short deck Flop (AA vs 98dd)", result.equities[0],
+                share / runouts, 1e-12);
+  assert_equity("Short deck flush share", result.categories[1][static_cast<int>(
+                                              HandCategory::Flush)],
+                flushes / runouts, 1e-12);
+
+  // Preflop samples (no full-deck table)
+  options.seed = 9;
+  EquityResult pre = EquityCalculator::calculate({aces, suited}, {}, options);
+  assert(!pre.exact);
+
+  bool threw = false;
+  try {
+    std::vector<Card> low = {Card(Card::RANK_5, Card::SUIT_CLUBS),
+                             Card(Card::RANK_5, Card::SUIT_SPADES)};
+    EquityCalculator::calculate({aces, low}, flop, options);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+void testThreadPool() {
+  std::cout << "\n--- TESTING THREAD POOL ---\n" << std::endl;
+
+  ThreadPool pool(3);
+
+  // Every index visited exactly once, including from nested calls
+  std::atomic<long long> sum{0};
+  std::atomic<long long> nestedSum{0};
+  pool.parallelFor(10000, 64, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      sum += i;
+    if (begin == 0) {
+      pool.parallelFor(100, 10, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++)
+          nestedSum += i;
+      });
+    }
+  });
+  assert(sum == 10000LL * 9999 / 2);
+  assert(nestedSum == 4950);
+
+  // Exceptions from a chunk reach the caller
+  bool caught = false;
+  try {
+    pool.parallelFor(10, 1, [](size_t begin, size_t) {
+      if (begin == 5)
+        throw std::runtime_error("chunk failed");
+    });
+  } catch (const std::runtime_error &) {
+    caught = true;
+  }
+  assert(caught);
+
+  std::cout << "[PASS] parallelFor (nested + exceptions)" << std::endl;
+}
+
+void testEquityScheduler() {
+  std::cout << "\n--- TESTING EQUITY SCHEDULER ---\n" << std::endl;
+
+  // Under load the budget shrinks, precision is loosened to match
+  EquityOptions options;
+  options.targetPrecision = 0.005;
+  EquityBudget{0.25}.apply(options);
+  assert(options.maxIterations == 25000);
+  assert(std::abs(options.targetPrecision - 0.01) < 1e-12);
+
+  EquityScheduler scheduler(1);
+  std::mutex mtx;
+  std::vector<std::string> ran;
+  std::vector<double> budgets;
+  auto job = [&](const std::string &name, double precision) {
+    return [&, name, precision](const EquityBudget &budget) {
+      std::lock_guard<std::mutex> lock(mtx);
+      ran.push_back(name);
+      budgets.push_back(budget.scale);
+      return precision;
+    };
+  };
+  auto later = EquityScheduler::Clock::now() + std::chrono::seconds(60);
+  auto past = EquityScheduler::Clock::now() - std::chrono::seconds(1);
+
+  // a1 holds the only slot until a newer job for room a cancels it
+  std::atomic<bool> a1Started{false};
+  scheduler.submit("a", later, [&](const EquityBudget &budget) {
+    a1Started = true;
+    while (!*budget.cancel)
+      std::this_thread::yield();
+    std::lock_guard<std::mutex> lock(mtx);
+    ran.push_back("a1");
+    return 0.5; // cancelled: not reported
+  });
+  while (!a1Started)
+    std::this_thread::yield();
+  scheduler.submit("b", later, job("b1", 0.02));
+  scheduler.submit("b", later, job("b2", 0.01)); // replaces b1
+  scheduler.submit("c", past, job("c1", 0.0));   // too late when its turn comes
+  scheduler.submit("a", later, job("a2", 0.03)); // cancels a1, queued behind b
+  scheduler.wait();
+
+  // Rooms take turns; b2 shared the slot with c and a waiting
+  assert((ran == std::vector<std::string>{"a1", "b2", "a2"}));
+  assert(std::abs(budgets[0] - 1.0 / 3) < 1e-12 && budgets[1] == 1.0);
+  auto m = scheduler.metrics();
+  assert(m.queueDepth == 0 && m.running == 0 && m.completed == 3);
+  assert(m.coalesced == 1 && m.shed == 1 && m.degraded == 1);
+  assert(m.lastPrecision == 0.03);
+  assert(std::abs(m.meanPrecision - 0.02) < 1e-12);
+
+  // Cancelling drops a waiting job
+  std::atomic<bool> release{false};
+  scheduler.submit("a", later, [&](const EquityBudget &) {
+    while (!release)
+      std::this_thread::yield();
+    return -1.0;
+  });
+  scheduler.submit("b", later, job("b3", 0.0));
+  scheduler.cancel("b");
+  release = true;
+  scheduler.wait();
+  assert(ran.back() == "a2" && scheduler.metrics().completed == 4);
+
+  // A job that throws is logged and counted, and the room carries on
+  scheduler.submit("a", later, [](const EquityBudget &) -> double {
+    throw std::runtime_error("test failure");
+  });
+  scheduler.wait();
+  scheduler.submit("a", later, job("a3", 0.04));
+  scheduler.wait();
+  m = scheduler.metrics();
+  assert(m.failed == 1 && m.completed == 6 && m.lastPrecision == 0.04);
+
+  std::cout << "[PASS] Equity scheduler (round robin, coalescing, shedding, "
+               "failures)"
+            << std::endl;
+}
+
+void testEquityCache() {
+  std::cout << "\n--- TESTING EQUITY CACHE ---\n" << std::endl;
+
+  EquityCache cache(2);
+  std::vector<Card> flop = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_K, Card::SUIT_SPADES),
+                            Card(Card::RANK_2, Card::SUIT_DIAMONDS)};
+  std::vector<Card> draw = {Card(Card::RANK_Q, Card::SUIT_SPADES),
+                            Card(Card::RANK_J, Card::SUIT_SPADES)};
+  std::vector<Card> topTwo = {Card(Card::RANK_A, Card::SUIT_DIAMONDS),
+                              Card(Card::RANK_K, Card::SUIT_DIAMONDS)};
+
+  auto first = cache.calculate({draw, topTwo}, flop);
+  auto again = cache.calculate({draw, topTwo}, flop);
+  assert(cache.stats().hits == 1 && cache.stats().misses == 1);
+  assert(again.equities == first.equities);
+
+  // Spades <-> hearts, diamonds <-> clubs, players swapped: same spot
+  std::vector<Card> flopIso = {Card(Card::RANK_2, Card::SUIT_CLUBS),
+                               Card(Card::RANK_K, Card::SUIT_HEARTS),
+                               Card(Card::RANK_A, Card::SUIT_HEARTS)};
+  std::vector<Card> drawIso = {Card(Card::RANK_J, Card::SUIT_HEARTS),
+                               Card(Card::RANK_Q, Card::SUIT_HEARTS)};
+  std::vector<Card> topTwoIso = {Card(Card::RANK_A, Card::SUIT_CLUBS),
+                                 Card(Card::RANK_K, Card::SUIT_CLUBS)};
+  auto iso = cache.calculate({topTwoIso, drawIso}, flopIso);
+  assert(cache.stats().hits == 2);
+  assert(iso.equities[0] == first.equities[1]);
+  assert(iso.equities[1] == first.equities[0]);
+  assert(iso.winRates[0] == first.winRates[1]);
+  assert(iso.categories[1] == first.categories[0]);
+
+  // Not isomorphic (the draw is no longer suited with the flop)
+  std::vector<Card> offDraw = {Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                               Card(Card::RANK_J, Card::SUIT_HEARTS)};
+  std::vector<int> order;
+  assert(EquityCache::canonicalKey({draw, topTwo}, flop, order) !=
+         EquityCache::canonicalKey({offDraw, topTwo}, flop, order));
+
+  // LRU: a third spot evicts the least recently used one
+  cache.calculate({offDraw, topTwo}, flop);
+  std::vector<Card> turn = flop;
+  turn.push_back(Card(Card::RANK_7, Card::SUIT_CLUBS));
+  cache.calculate({draw, topTwo}, turn);
+  assert(cache.stats().size == 2);
+  cache.calculate({draw, topTwo}, flop);
+  assert(cache.stats().misses == 4);
+
+
+  // The shared LRU: a lookup refreshes an entry, a re-store keeps the first
+  LruCache<int, int> lru(2);
+  int value = 0;
+  lru.put(1, 10);
+  lru.put(2, 20);
+  lru.put(1, 11);
+  assert(lru.get(1, value) && value == 10);
+  lru.put(3, 30);
+  assert(lru.size() == 2 && !lru.get(2, value) && lru.get(1, value));
+
+  // usePreflopTable is part of the key: a sampled preflop answer is never
+  // served for a table lookup, nor the other way round
+  EquityCache preflop(4);
+  std::vector<Card> aces = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                            Card(Card::RANK_A, Card::SUIT_HEARTS)};
+  std::vector<Card> kings = {Card(Card::RANK_K, Card::SUIT_SPADES),
+                             Card(Card::RANK_K, Card::SUIT_HEARTS)};
+  EquityOptions sampled;
+  sampled.seed = 5;
+  sampled.usePreflopTable = false;
+  EquityOptions tabled = sampled;
+  tabled.usePreflopTable = true;
+  auto sampledResult = preflop.calculate({aces, kings}, {}, sampled);
+  assert(!sampledResult.exact);
+  preflop.calculate({aces, kings}, {}, tabled);
+  assert(preflop.stats().hits == 0 && preflop.stats().size == 2);
+  assert(preflop.calculate({aces, kings}, {}, sampled).equities ==
+         sampledResult.equities);
+  assert(preflop.stats().hits == 1);
+
+  std::cout << "[PASS] Equity cache (hits, isomorphism, LRU)" << std::endl;
+
+  // Hero vs random hands: isomorphic heroes share one computation
+  // (QhJh and QcJc only differ by suits the flop doesn't use)
+  std::vector<Card> offDrawIso = {Card(Card::RANK_Q, Card::SUIT_CLUBS),
+                                  Card(Card::RANK_J, Card::SUIT_CLUBS)};
+  EquityCache heroes(8);
+  EquityOptions options;
+  options.seed = 3;
+  auto vsRandom = heroes.calculateVsRandom({offDraw, offDrawIso, topTwo}, flop,
+                                           {1, 1, 2}, options);
+  assert(vsRandom.size() == 3);
+  assert(vsRandom[0].equities == vsRandom[1].equities);
+  assert(vsRandom[0].equities.size() == 2);
+  assert(vsRandom[2].equities.size() == 3);
+  assert(heroes.stats().misses == 2 && heroes.stats().size == 2);
+  // Top two pair on AK2 is well ahead of one random hand, less of two
+  auto repeat = heroes.calculateVsRandom({topTwo}, flop, {2}, options);
+  assert(heroes.stats().hits == 1);
+  assert(repeat[0].equities == vsRandom[2].equities);
+  assert(vsRandom[2].equities[0] > 0.7);
+
+  std::cout << "[PASS] Hero equity vs random hands (batch, dedupe)"
+            << std::endl;
+
+  // Batch: the isomorphic, swapped problem and the duplicate are solved
+  // once, results come back in order and in each problem's player order
+  EquityCache batch(8);
+  std::vector<Card> dead = {Card(Card::RANK_5, Card::SUIT_HEARTS)};
+  auto results = batch.calculateBatch({{{draw, topTwo}, flop, {}},
+                                       {{topTwoIso, drawIso}, flopIso, {}},
+                                       {{draw, topTwo}, flop, {}},
+                                       {{draw, topTwo}, turn, dead}});
+  assert(results.size() == 4);
+  assert(batch.stats().misses == 2 && batch.stats().size == 2);
+  assert(results[0].equities == first.equities);
+  assert(results[1].equities[0] == results[0].equities[1]);
+  assert(results[1].equities[1] == results[0].equities[0]);
+  assert(results[2].equities == results[0].equities);
+  EquityOptions withDead;
+  withDead.deadCards = dead;
+  auto turnDead = EquityCalculator::calculate({draw, topTwo}, turn, withDead);
+  assert(results[3].equities == turnDead.equities);
+
+  std::cout << "[PASS] Batch equity (order, dedupe, dead cards)" << std::endl;
+}
+
+void testPreflopTable() {
+  std::cout << "\n--- TESTING PREFLOP TABLE ---\n" << std::endl;
+
+  std::vector<Card> ak = {Card(Card::RANK_A, Card::SUIT_SPADES),
+                          Card(Card::RANK_K, Card::SUIT_SPADES)};
+  std::vector<Card> aq = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                          Card(Card::RANK_Q, Card::SUIT_HEARTS)};
+
+  // Exact enumeration (what the generator stores) agrees with sampling
+  EquityOptions exact;
+  exact.forceExact = true;
+  exact.usePreflopTable = false;
+  EquityResult full = EquityCalculator::calculate({ak, aq}, {}, exact);
+  assert(full.exact && full.iterations == 1712304);
+  assert_equity("Exact Preflop (AKs vs AQs)", full.equities[0], 0.70, 0.03);
+
+  // Missing or malformed files are ignored
+  assert(!PreflopTable("does_not_exist.bin").loaded());
+  const char *path = "test_preflop_table.bin";
+  FILE *bad = std::fopen(path, "wb");
+  std::fputs("not a table", bad);
+  std::fclose(bad);
+  assert(!PreflopTable(path).loaded());
+
+  // Round trip through a file in the generator's format
+  const int n = PreflopTable::NUM_COMBOS;
+  std::vector<uint16_t> entries(static_cast<size_t>(n) * n, 0);
+  int a = BoardRankTable::comboIndex(ak[0], ak[1]);
+  int b = BoardRankTable::comboIndex(aq[0], aq[1]);
+  uint16_t value = static_cast<uint16_t>(std::lround(full.equities[0] * 65535));
+  entries[static_cast<size_t>(a) * n + b] = value;
+  entries[static_cast<size_t>(b) * n + a] = 65535 - value;
+  uint32_t header[4] = {PreflopTable::MAGIC, PreflopTable::VERSION,
+                        static_cast<uint32_t>(n), 0};
+  FILE *out = std::fopen(path, "wb");
+  std::fwrite(header, sizeof(header), 1, out);
+  std::fwrite(entries.data(), sizeof(uint16_t), entries.size(), out);
+  std::fclose(out);
+
+  {
+    PreflopTable table(path);
+    assert(table.loaded());
+    assert_equity("Table Lookup", table.equity(ak[0], ak[1], aq[0], aq[1]),
+                  full.equities[0], 1e-4);
+    assert_equity("Table Lookup (swapped)",
+                  table.equity(aq[1], aq[0], ak[0], ak[1]),
+                  1.0 - full.equities[0], 1e-4);
+    assert(table.equity(ak[0], ak[1], ak[0], aq[1]) < 0); // shared card
+  }
+  std::remove(path);
+
+  std::cout << "[PASS] Preflop table (exact, file format)" << std::endl;
+}
+
+static bool rangeThrows(const std::string &text) {
+  try {
+    Range::parse(text);
+  } catch (const std::invalid_argument &) {
+    return true;
+  }
+  return false;
+}
+
+void testRanges() {
+  std::cout << "\n--- TESTING RANGES ---\n" << std::endl;
+
+  // Parser
+  assert(Range::parse("AA").size() == 6);
+  assert(Range::parse("AKs").size() == 4);
+  assert(Range::parse("AKo").size() == 12);
+  assert(Range::parse("AK").size() == 16);
+  assert(Range::parse("TT+").size() == 30);
+  assert(Range::parse("ATs+").size() == 16);
+  assert(Range::parse("A5s-A2s").size() == 16);
+  assert(Range::parse("44-22").size() == 18);
+  assert(Range::parse("AhKh").size() == 1);
+  assert(Range::parse("AKs, TT+, A5s-A2s").size() == 4 + 30 + 16);
+  assert(std::abs(Range::parse("AKs:0.5").totalWeight() - 2.0) < 1e-9);
+  assert(Range::all().size() == 1326);
+  assert(rangeThrows("AAs") && rangeThrows("XY") && rangeThrows("AK:2") &&
+         rangeThrows("A5s-K2s") && rangeThrows("AhAh"));
+  std::cout << "[PASS] Range parser" << std::endl;
+
+  std::vector<Card> aces = {Card(Card::RANK_A, Card::SUIT_HEARTS),
+                            Card(Card::RANK_A, Card::SUIT_SPADES)};
+  std::vector<Card> river = {Card(Card::RANK_K, Card::SUIT_HEARTS),
+                             Card(Card::RANK_Q, Card::SUIT_HEARTS),
+                             Card(Card::RANK_7, Card::SUIT_HEARTS),
+                             Card(Card::RANK_2, Card::SUIT_CLUBS),
+                             Card(Card::RANK_9, Card::SUIT_DIAMONDS)};
+
+  // River heads-up is exact: the weighted average of every combo
+  Range villain = Range::parse("KK, QQ, AJs, T8s:0.5, JTs");
+  EquityResult exact =
+      EquityCalculator::calculateVsRanges(aces, {villain}, river);
+  assert(exact.exact);
+
+  CardSet dead = CardSet::fromCards(aces) | CardSet::fromCards(river);
+  double weighted = 0.0;
+  double totalWeight = 0.0;
+  for (int combo = 0; combo < Range::NUM_COMBOS; combo++) {
+    Card a, b;
+    BoardRankTable::comboCards(combo, a, b);
+    if (villain.weight(combo) <= 0 || dead.contains(a) || dead.contains(b))
+      continue;
+    double eq = EquityCalculator::calculate({aces, {a, b}}, river).equities[0];
+    weighted += villain.weight(combo) * eq;
+    totalWeight += villain.weight(combo);
+  }
+  assert_equity("Hand vs Range (river, exact)", exact.equities[0],
+                weighted / totalWeight, 1e-9);
+
+  // Sampled streets
+  EquityOptions seeded;
+  seeded.seed = 4242;
+  auto vsRandom =
+      EquityCalculator::calculateVsRanges(aces, {Range::all()}, {}, seeded);
+  assert_equity("AA vs Random (Preflop)", vsRandom.equities[0], 0.852, 0.01);
+
+  // Card removal: only AcAd is left, so mostly a chop
+  auto vsAces = EquityCalculator::calculateVsRanges(
+      aces, {Range::parse("AA")}, {}, seeded);
+  assert_equity("AA vs AA (card removal)", vsAces.equities[0], 0.5, 0.02);
+
+  auto rangeVsRange = EquityCalculator::calculateRanges(
+      {Range::parse("QQ+, AKs"), Range::parse("JJ-22")}, {}, seeded);
+  assert_equity("QQ+,AKs vs JJ-22 (Preflop)",
+                rangeVsRange.equities[0] + rangeVsRange.equities[1], 1.0,
+                1e-9);
+  assert(rangeVsRange.equities[0] > 0.6);
+
+  bool clash = false;
+  try {
+    EquityCalculator::calculateRanges(
+        {Range::parse("AhKh"), Range::parse("AhQh")}, {}, seeded);
+  } catch (const std::invalid_argument &) {
+    clash = true;
+  }
+  assert(clash);
+  std::cout << "[PASS] Range equity" << std::endl;
+}
+
 int main() {
+  testThreadPool();
   testEquity();
+  testEquityCache();
+  testEquityScheduler();
+  testPreflopTable();
+  testRanges();
+  testHeatmap();
+  testHandStrength();
+  testOmahaEquity();
+  testShortDeckEquity();
   return 0;
 }
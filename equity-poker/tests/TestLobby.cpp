@@ -1,6 +1,12 @@
+#include "../src/poker/EquityCache.h"
 #include "../src/server/Lobby.h"
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <nlohmann/json.hpp>
+#include <thread>
 
 using namespace poker;
 using namespace std;
@@ -159,6 +165,226 @@ void testFoldWinBlocking() {
   log("Passed.");
 }
 
+void testAsyncEquity() {
+  log("Testing Equity Snapshot (async jobs)...");
+  Lobby lobby;
+  lobby.join("p1", "Alice");
+  lobby.join("p2", "Bob");
+  lobby.sitPlayer("p1", 0, 1000);
+  lobby.sitPlayer("p2", 1, 1000);
+  assert(lobby.startGame("p1") == true);
+
+  // The snapshot holds both live hands and is independent of the lobby
+  EquityRequest request = lobby.equityRequest();
+  assert(request.hands.size() == 2);
+  assert(request.seatIndices.size() == 2);
+  assert(request.board.empty());
+
+  // A cancelled job gives nothing back (and caches nothing)
+  std::atomic<bool> cancel{true};
+  assert(Lobby::computeEquities(request, &cancel).empty());
+
+  nlohmann::json equities = Lobby::computeEquities(request);
+  assert(equities.size() == 2);
+  assert(equities.contains("0") && equities.contains("1"));
+
+  // Folded hands are dead, not live
+  Lobby three;
+  three.join("p1", "Alice");
+  three.join("p2", "Bob");
+  three.join("p3", "Carol");
+  for (int i = 0; i < 3; i++)
+    three.sitPlayer("p" + std::to_string(i + 1), i, 1000);
+  assert(three.startGame("p1") == true);
+  const Game &g = three.getGame();
+  const Player &actor = g.getSeats()[g.getCurrentActor()];
+  std::vector<Card> folded = actor.hand;
+  assert(three.handleGameAction(actor.id, "fold", 0));
+  request = three.equityRequest();
+  assert(request.hands.size() == 2);
+  assert(request.dead == folded);
+
+  // Win / tie / categories come with the same job
+  nlohmann::json breakdown;
+  equities = Lobby::computeEquities(request, nullptr, nullptr, &breakdown);
+  assert(breakdown.size() == 2);
+  for (auto &[seat, stats] : breakdown.items()) {
+    double equity = equities[seat];
+    double win = stats["win"];
+    double tie = stats["tie"];
+    assert(std::abs(win + tie / 2 - equity) < 1e-9);
+    assert(!stats["categories"].empty());
+  }
+
+  log("Passed.");
+}
+
+void testHeroEquity() {
+  log("Testing Hero Equity (opt-in, vs random hands)...");
+  Lobby lobby;
+  lobby.join("p1", "Alice");
+  lobby.join("p2", "Bob");
+  lobby.join("p3", "Carol");
+  lobby.sitPlayer("p1", 0, 1000);
+  lobby.sitPlayer("p2", 1, 1000);
+  lobby.sitPlayer("p3", 2, 1000);
+  assert(lobby.startGame("p1") == true);
+
+  // Off by default
+  assert(lobby.equityRequest().heroes.empty());
+  assert(!lobby.toJsonForViewer("p1").contains("heroEquity"));
+
+  assert(lobby.setHeroEquity("p1", true));
+  assert(!lobby.setHeroEquity("nobody", true));
+  EquityRequest request = lobby.equityRequest();
+  assert(request.heroes.size() == 1);
+  assert(request.heroes[0].userId == "p1");
+  assert(request.heroes[0].opponents == 2);
+  assert(request.heroes[0].hand == lobby.getGame().getSeats()[0].hand);
+
+  // Cancelled first: a cached result would come back regardless
+  std::atomic<bool> cancel{true};
+  assert(Lobby::computeHeroEquities(request, &cancel).empty());
+
+  nlohmann::json heroEquities = Lobby::computeHeroEquities(request);
+  assert(heroEquities.size() == 1 && heroEquities.contains("p1"));
+  double equity = heroEquities["p1"];
+  assert(equity > 0.0 && equity < 1.0);
+
+  // Only the hero sees it, and only their own
+  auto mine = lobby.toJsonForViewer("p1", false, nullptr, &heroEquities);
+  assert(mine["heroEquity"] == heroEquities["p1"]);
+  assert(!lobby.toJsonForViewer("p2", false, nullptr, &heroEquities)
+              .contains("heroEquity"));
+
+  log("Passed.");
+}
+
+void testHeatmapAccess() {
+  log("Testing Heatmap Access...");
+  Lobby lobby;
+  lobby.join("p1", "Alice");
+  lobby.join("p2", "Bob");
+  lobby.join("s1", "Sam");
+  lobby.sitPlayer("p1", 0, 1000);
+  lobby.sitPlayer("p2", 1, 1000);
+
+  // Without god mode spectators see no hands
+  LobbyConfig config = lobby.getLobbyConfig();
+  config.godMode = false;
+  assert(lobby.updateConfig("p1", config));
+  assert(lobby.startGame("p1") == true);
+  HeatmapRequest request;
+  assert(!lobby.heatmapRequest("s1", 1, request));
+  assert(lobby.endGame("p1"));
+  config.godMode = true;
+  assert(lobby.updateConfig("p1", config));
+  assert(lobby.startGame("p1") == true);
+
+  // Own hand yes, someone else's no; god-mode spectators see every seat
+  assert(lobby.heatmapRequest("p1", 0, request));
+  assert(request.hand == lobby.getGame().getSeats()[0].hand);
+  assert(request.dead.empty());
+  assert(!lobby.heatmapRequest("p1", 1, request));
+  assert(lobby.heatmapRequest("s1", 1, request));
+  assert(!lobby.heatmapRequest("s1", 5, request));
+
+  nlohmann::json heatmap = Lobby::computeHeatmap(request);
+  assert(heatmap["equity"].size() == 13 && heatmap["equity"][0].size() == 13);
+  assert(heatmap["combos"].size() == 13);
+
+  log("Passed.");
+}
+
+// Calls / checks for whoever is to act until the stage changes
+static void finishStreet(Game &g) {
+  GameStage stage = g.getStage();
+  while (g.getStage() == stage) {
+    const Player &actor = g.getSeats()[g.getCurrentActor()];
+    bool facingBet = g.getCurrentBet() > actor.currentBet;
+    assert(g.playerAction(actor.id, facingBet ? "call" : "check", 0));
+  }
+}
+
+void testNextStreetSpeculation() {
+  log("Testing Next-Street Speculation...");
+  Lobby lobby;
+  Game &g = lobby.getGame();
+  lobby.join("p1", "Alice");
+  lobby.join("p2", "Bob");
+  lobby.sitPlayer("p1", 0, 1000);
+  lobby.sitPlayer("p2", 1, 1000);
+  assert(lobby.startGame("p1") == true);
+
+  // Nothing is speculated preflop
+  finishStreet(g);
+  assert(g.getStage() == GameStage::Flop);
+  assert(lobby.equityRequest().speculation == nullptr);
+  // The flop burn is out of play
+  assert(g.getBurnedCards().size() == 1);
+  assert(lobby.equityRequest().dead == g.getBurnedCards());
+
+  // Turn: no speculation (computeOuts walks every river), the turn job
+  // starts one for the river
+  finishStreet(g);
+  assert(g.getStage() == GameStage::Turn);
+  EquityRequest turn = lobby.equityRequest();
+  assert(turn.speculation == nullptr);
+
+  // Turn outs: one entry per river that can come, outs by seat
+  // The same pass gives the current equities and breakdown
+  assert(turn.dead.size() == 2);
+  EquityOptions withBurns;
+  withBurns.deadCards = turn.dead;
+  auto turnExact =
+      EquityCalculator::calculate(turn.hands, turn.board, withBurns);
+  nlohmann::json outsEquities, outsBreakdown;
+  nlohmann::json outs =
+      Lobby::computeOuts(turn, nullptr, &outsEquities, &outsBreakdown);
+  assert(outs["cards"].size() == 52 - 4 - 4 - turn.dead.size());
+  assert(outs["outs"].size() == 2);
+  assert(outsBreakdown.size() == 2);
+  for (size_t i = 0; i < turn.seatIndices.size(); i++) {
+    double got = outsEquities[std::to_string(turn.seatIndices[i])];
+    assert(std::abs(got - turnExact.equities[i]) < 1e-9);
+  }
+  // Cached: a repeat is answered even once the job is cancelled
+  std::atomic<bool> cancelled{true};
+  assert(Lobby::computeOuts(turn, &cancelled) == outs);
+
+  // River: the turn job covered every river card
+  finishStreet(g);
+  assert(g.getStage() == GameStage::River);
+  EquityRequest request = lobby.equityRequest();
+  assert(request.speculation != nullptr);
+  for (int i = 0; i < 500 && !request.speculation->ready; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  assert(request.speculation->ready);
+
+  auto before = EquityCache::instance().stats();
+  nlohmann::json equities = Lobby::computeEquities(request);
+  auto after = EquityCache::instance().stats();
+  assert(after.hits == before.hits && after.misses == before.misses);
+
+  // All three burns are dead, the river one was known to the turn job
+  assert(request.dead.size() == 3);
+  withBurns.deadCards = request.dead;
+  auto exact =
+      EquityCalculator::calculate(request.hands, request.board, withBurns);
+  for (size_t i = 0; i < request.seatIndices.size(); i++) {
+    double got = equities[std::to_string(request.seatIndices[i])];
+    assert(std::abs(got - exact.equities[i]) < 1e-9);
+  }
+  assert(Lobby::computeOuts(request).empty());
+
+  // A fold drops it
+  const Player &actor = g.getSeats()[g.getCurrentActor()];
+  assert(lobby.handleGameAction(actor.id, "fold", 0));
+  assert(lobby.equityRequest().speculation == nullptr);
+
+  log("Passed.");
+}
+
 int main() {
   testHostAssignment();
   testAccessControl();
@@ -166,6 +392,10 @@ int main() {
   testConfigUpdates();
   testRebuy();
   testFoldWinBlocking();
+  testAsyncEquity();
+  testHeroEquity();
+  testHeatmapAccess();
+  testNextStreetSpeculation();
   cout << "ALL LOBBY TESTS PASSED!" << endl;
   return 0;
 }
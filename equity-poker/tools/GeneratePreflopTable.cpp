@@ -0,0 +1,94 @@
+// Offline generator for the heads-up preflop equity table (PreflopTable)
+// Usage: gen_preflop_table [output file]   (default: preflop_equity.bin)
+//
+// Every matchup is enumerated exactly over all 1,712,304 boards. Only one
+// matchup per suit-isomorphism class is computed (~47k instead of ~812k),
+// the rest are copied. Takes a while: run it once and ship the file.
+
+#include "../src/poker/BoardRankTable.h"
+#include "../src/poker/EquityCache.h"
+#include "../src/poker/EquityCalculator.h"
+#include "../src/poker/PreflopTable.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace poker;
+
+int main(int argc, char **argv) {
+  std::string path = argc > 1 ? argv[1] : "preflop_equity.bin";
+  const int n = PreflopTable::NUM_COMBOS;
+
+  EquityOptions exact;
+  exact.forceExact = true;
+  exact.usePreflopTable = false;
+
+  // Canonical class -> equity of the class's first hand
+  std::unordered_map<std::string, double> classEquity;
+  std::vector<uint16_t> table(static_cast<size_t>(n) * n, 0);
+  auto started = std::chrono::steady_clock::now();
+
+  for (int a = 0; a < n; a++) {
+    std::vector<Card> handA(2);
+    BoardRankTable::comboCards(a, handA[0], handA[1]);
+
+    for (int b = a + 1; b < n; b++) {
+      std::vector<Card> handB(2);
+      BoardRankTable::comboCards(b, handB[0], handB[1]);
+      if (handA[0] == handB[0] || handA[0] == handB[1] ||
+          handA[1] == handB[0] || handA[1] == handB[1])
+        continue;
+
+      std::vector<int> order;
+      std::string key = EquityCache::canonicalKey({handA, handB}, {}, order);
+      auto it = classEquity.find(key);
+      if (it == classEquity.end()) {
+        // Computed in canonical order so the class value is well defined
+        std::vector<std::vector<Card>> hands(2);
+        hands[order[0]] = handA;
+        hands[order[1]] = handB;
+        double first =
+            EquityCalculator::calculate(hands, {}, exact).equities[0];
+        it = classEquity.emplace(key, first).first;
+      }
+
+      double equityA = order[0] == 0 ? it->second : 1.0 - it->second;
+      uint16_t value = static_cast<uint16_t>(std::lround(equityA * 65535));
+      table[static_cast<size_t>(a) * n + b] = value;
+      table[static_cast<size_t>(b) * n + a] = 65535 - value;
+    }
+
+    if (a % 26 == 25) {
+      auto secs = std::chrono::duration_cast<std::chrono::seconds>(
+                      std::chrono::steady_clock::now() - started)
+                      .count();
+      std::cout << "combo " << a + 1 << "/" << n << ", "
+                << classEquity.size() << " classes, " << secs << "s"
+                << std::endl;
+    }
+  }
+
+  FILE *out = std::fopen(path.c_str(), "wb");
+  if (!out) {
+    std::cerr << "Cannot write " << path << std::endl;
+    return 1;
+  }
+  uint32_t header[4] = {PreflopTable::MAGIC, PreflopTable::VERSION,
+                        static_cast<uint32_t>(n), 0};
+  bool ok = std::fwrite(header, sizeof(header), 1, out) == 1 &&
+            std::fwrite(table.data(), sizeof(uint16_t), table.size(), out) ==
+                table.size();
+  ok = std::fclose(out) == 0 && ok;
+  if (!ok) {
+    std::cerr << "Failed writing " << path << std::endl;
+    return 1;
+  }
+
+  std::cout << "Wrote " << path << " (" << classEquity.size()
+            << " matchup classes)" << std::endl;
+  return 0;
+}